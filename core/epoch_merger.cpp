@@ -0,0 +1,228 @@
+#include "epoch_merger.h"
+
+#include <algorithm>
+
+EpochMerger::EpochMerger(Config config)
+    : config_(config)
+    , sources_(std::max<size_t>(config.receivers, 1U))
+{
+    merged_.sources.resize(sources_.size());
+}
+
+void EpochMerger::setUpdateHandler(UpdateHandler handler)
+{
+    handler_ = std::move(handler);
+}
+
+void EpochMerger::onEpoch(size_t receiver, const GnssPvt& pvt, const UbxNavPvtMsg& nav_pvt, int64_t rx_time_ns)
+{
+    if (receiver >= sources_.size())
+        return;
+
+    Source& source = sources_[receiver];
+    SourceHealth& h = source.health;
+    const bool new_epoch = h.epochs == 0U || h.itow != nav_pvt.itow.value();
+
+    source.pvt = pvt;
+    source.nav_pvt = nav_pvt;
+    h.connected = true;
+    h.fix_ok = nav_pvt.flags.gnss_fix_ok;
+    h.itow = nav_pvt.itow.value();
+    h.fix_type = nav_pvt.fix_type;
+    h.carr_soln = nav_pvt.flags.carr_soln;
+    h.horizontal_acc = nav_pvt.horizontal_acc.value();
+    h.last_rx_ns = rx_time_ns;
+    if (new_epoch)
+        ++h.epochs;
+
+    updateHealth(rx_time_ns);
+    const bool changed = new_epoch && select(receiver);
+    if (changed || receiver == selected_)
+        build();
+    publish();
+}
+
+void EpochMerger::onRelPosNed(size_t receiver, const UbxNavRelposnedMsg& relpos)
+{
+    if (receiver >= sources_.size())
+        return;
+
+    sources_[receiver].relpos = relpos;
+    sources_[receiver].have_relpos = true;
+
+    // the rover's RELPOSNED can trail the NAV-PVT it belongs to
+    if (merged_.valid && relpos.itow.value() == merged_.itow)
+    {
+        build();
+        publish();
+    }
+}
+
+void EpochMerger::setConnected(size_t receiver, bool connected, int64_t now_ns)
+{
+    if (receiver >= sources_.size())
+        return;
+
+    sources_[receiver].health.connected = connected;
+    poll(now_ns);
+}
+
+void EpochMerger::poll(int64_t now_ns)
+{
+    updateHealth(now_ns);
+    if (select(sources_.size()))
+        build();
+    publish();
+}
+
+void EpochMerger::updateHealth(int64_t now_ns)
+{
+    for (Source& source : sources_)
+    {
+        SourceHealth& h = source.health;
+        // 2D, 3D and GNSS + dead reckoning; not time-only
+        const bool usable_fix = h.fix_ok && h.fix_type >= 2U && h.fix_type <= 4U;
+        h.healthy = h.connected && h.epochs > 0U && usable_fix &&
+                    now_ns - h.last_rx_ns <= config_.stale_after_ns;
+    }
+}
+
+int EpochMerger::rank(const SourceHealth& h) const
+{
+    if (!h.healthy)
+        return -1;
+    // RTK fixed > float > none, then 3D over 2D
+    const bool three_d = h.fix_type == 3U || h.fix_type == 4U;
+    return h.carr_soln * 2 + (three_d ? 1 : 0);
+}
+
+bool EpochMerger::better(const SourceHealth& a, const SourceHealth& b) const
+{
+    const int ra = rank(a);
+    const int rb = rank(b);
+    if (ra != rb)
+        return ra > rb;
+    return ra >= 0 && a.horizontal_acc < b.horizontal_acc * config_.switch_accuracy_ratio;
+}
+
+size_t EpochMerger::best() const
+{
+    // start from the selected source so ties keep it
+    size_t top = selected_;
+    for (size_t i = 0; i < sources_.size(); ++i)
+    {
+        if (better(sources_[i].health, sources_[top].health))
+            top = i;
+    }
+    return top;
+}
+
+bool EpochMerger::select(size_t receiver_with_epoch)
+{
+    const size_t top = best();
+
+    if (!sources_[selected_].health.healthy)
+    {
+        // failover: take anything healthy right away
+        if (top == selected_ || !sources_[top].health.healthy)
+            return false;
+        changeSource(top);
+        return true;
+    }
+
+    if (top == selected_)
+    {
+        candidate_wins_ = 0;
+        return false;
+    }
+
+    if (top != candidate_)
+    {
+        candidate_ = top;
+        candidate_wins_ = 0;
+    }
+
+    // count the candidate's own epochs, so N receivers don't speed it up
+    if (receiver_with_epoch != candidate_ || ++candidate_wins_ < config_.switch_epochs)
+        return false;
+
+    changeSource(top);
+    return true;
+}
+
+void EpochMerger::changeSource(size_t receiver)
+{
+    selected_ = receiver;
+    candidate_wins_ = 0;
+    ++merged_.source_changes;
+    // the antennas are apart; the jump between them is not distance driven
+    odometer_.restartSegment();
+}
+
+void EpochMerger::build()
+{
+    const Source& source = sources_[selected_];
+    if (source.health.epochs == 0U)
+        return;
+
+    merged_.valid = true;
+    merged_.source = selected_;
+    merged_.itow = source.health.itow;
+    merged_.pvt = source.pvt;
+    merged_.nav_pvt = source.nav_pvt;
+
+    merged_.aligned = 0U;
+    merged_.dual_heading = DualHeading{};
+    for (size_t i = 0; i < sources_.size(); ++i)
+    {
+        const Source& s = sources_[i];
+        if (s.health.connected && s.health.epochs > 0U && s.health.itow == merged_.itow)
+            ++merged_.aligned;
+
+        const UbxNavRelposnedMsg& r = s.relpos;
+        if (!s.have_relpos || r.itow.value() != merged_.itow || merged_.dual_heading.valid)
+            continue;
+        if (!r.flags.gnss_fix_ok || !r.flags.rel_pos_valid || !r.flags.rel_pos_heading_valid)
+            continue;
+
+        merged_.dual_heading.valid = true;
+        merged_.dual_heading.heading = r.rel_pos_heading.value() * 1e-5f;
+        merged_.dual_heading.accuracy = r.acc_heading.value() * 1e-5f;
+        merged_.dual_heading.baseline_m = r.rel_pos_length.value() * 1e-2f + r.rel_pos_hp_length * 1e-4f;
+        merged_.dual_heading.receiver = i;
+    }
+
+    // unlike heading of motion, the dual heading holds while stopped; a
+    // trailing RELPOSNED replaces the epoch's sample rather than adding one
+    HeadingFilter::Sample sample = HeadingFilter::fromNavPvt(source.nav_pvt);
+    if (merged_.dual_heading.valid)
+    {
+        sample.heading = merged_.dual_heading.heading;
+        sample.accuracy = merged_.dual_heading.accuracy;
+        sample.needs_motion = false;
+    }
+    merged_.heading = heading_filter_.update(sample);
+    if (merged_.heading.valid)
+    {
+        merged_.pvt.heading = merged_.heading.heading;
+        merged_.pvt.cardinal_direction = degreesToCardinal(merged_.heading.sector * 45.0f);
+    }
+
+    // a HPPOSLLH refresh of the same epoch must not count twice
+    if (!odometer_fed_ || odometer_itow_ != merged_.itow)
+    {
+        odometer_.update(source.nav_pvt);
+        odometer_itow_ = merged_.itow;
+        odometer_fed_ = true;
+    }
+    merged_.odometer_m = odometer_.meters();
+}
+
+void EpochMerger::publish()
+{
+    for (size_t i = 0; i < sources_.size(); ++i)
+        merged_.sources[i] = sources_[i].health;
+
+    if (handler_)
+        handler_(merged_);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "devices/ubx_types.h"
+#include "gnss_pvt.h"
+#include "heading_filter.h"
+#include "odometer.h"
+
+// Combines the epochs of several receivers into one solution. Epochs are
+// matched by receiver time of week: the merged state carries the position
+// and velocity of the selected source and the dual-antenna heading of the
+// same itow, when a rover reported one; the heading shown is smoothed and
+// held through stops by a HeadingFilter. The selected source fails over to
+// the healthiest receiver when it loses its fix or goes quiet, and moves to
+// a clearly better one after it has won several epochs in a row.
+//
+// Not thread-safe: call everything from the thread the receivers run on and
+// copy the result out in the update handler.
+class EpochMerger {
+    public:
+    struct Config {
+        size_t receivers{1U};
+        int64_t stale_after_ns{1'500'000'000}; // no epoch for this long is a lost source
+        int switch_epochs{5};                 // epochs a better source must win in a row
+        float switch_accuracy_ratio{0.5f};    // same fix class: h_acc must beat this share
+    };
+
+    struct SourceHealth {
+        bool connected{};
+        bool healthy{};
+        bool fix_ok{};
+        uint32_t itow{};
+        uint8_t fix_type{};
+        uint8_t carr_soln{};
+        uint32_t horizontal_acc{}; // mm
+        int64_t last_rx_ns{};
+        uint64_t epochs{};
+    };
+
+    struct DualHeading {
+        bool valid{};
+        float heading{};    // degrees, base antenna to rover antenna
+        float accuracy{};   // degrees
+        float baseline_m{};
+        size_t receiver{};  // rover that reported it
+    };
+
+    struct Merged {
+        bool valid{};
+        size_t source{};   // receiver the solution comes from
+        uint32_t itow{};
+        size_t aligned{};  // receivers whose latest epoch is itow
+        GnssPvt pvt{};     // heading and cardinal from the heading filter once it has one
+        UbxNavPvtMsg nav_pvt{}; // raw, of the same source and itow
+        DualHeading dual_heading{};
+        HeadingFilter::Output heading{};
+        double odometer_m{};
+        uint64_t source_changes{};
+        std::vector<SourceHealth> sources;
+    };
+
+    using UpdateHandler = std::function<void(const Merged& merged)>;
+
+    explicit EpochMerger(Config config);
+
+    void setUpdateHandler(UpdateHandler handler);
+
+    // NAV-PVT, or a refinement of it (HPPOSLLH) for the same itow
+    void onEpoch(size_t receiver, const GnssPvt& pvt, const UbxNavPvtMsg& nav_pvt, int64_t rx_time_ns);
+    void onRelPosNed(size_t receiver, const UbxNavRelposnedMsg& relpos);
+    void setConnected(size_t receiver, bool connected, int64_t now_ns);
+    // re-checks health without new data, catches a receiver that went quiet
+    void poll(int64_t now_ns);
+
+    const Merged& merged() const { return merged_; }
+
+    private:
+    struct Source {
+        SourceHealth health;
+        GnssPvt pvt;
+        UbxNavPvtMsg nav_pvt{};
+        UbxNavRelposnedMsg relpos{};
+        bool have_relpos{};
+    };
+
+    Config config_;
+    std::vector<Source> sources_;
+    size_t selected_{};
+    size_t candidate_{};
+    int candidate_wins_{};
+
+    Odometer odometer_;
+    HeadingFilter heading_filter_;
+    uint32_t odometer_itow_{};
+    bool odometer_fed_{};
+
+    Merged merged_;
+    UpdateHandler handler_;
+
+    void updateHealth(int64_t now_ns);
+    int rank(const SourceHealth& h) const;
+    bool better(const SourceHealth& a, const SourceHealth& b) const;
+    size_t best() const;
+    bool select(size_t receiver_with_epoch);
+    void changeSource(size_t receiver);
+    void build();
+    void publish();
+};
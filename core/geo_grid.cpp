@@ -0,0 +1,30 @@
+#include "geo_grid.h"
+
+#include <algorithm>
+
+namespace geo_grid {
+
+namespace {
+constexpr int64_t kLatSpanE7{1800000000};
+constexpr int64_t kLonSpanE7{3600000000};
+} // namespace
+
+uint32_t columns(int32_t cell_e7)
+{
+    return static_cast<uint32_t>((kLonSpanE7 + cell_e7 - 1) / cell_e7);
+}
+
+uint32_t row(int32_t lat, int32_t cell_e7)
+{
+    const int64_t rows = (kLatSpanE7 + cell_e7 - 1) / cell_e7;
+    const int64_t r = (static_cast<int64_t>(lat) + kLatSpanE7 / 2) / cell_e7;
+    return static_cast<uint32_t>(std::clamp<int64_t>(r, 0, rows - 1));
+}
+
+uint32_t column(int32_t lon, int32_t cell_e7)
+{
+    const int64_t c = (static_cast<int64_t>(lon) + kLonSpanE7 / 2) / cell_e7;
+    return static_cast<uint32_t>(std::clamp<int64_t>(c, 0, int64_t{columns(cell_e7)} - 1));
+}
+
+} // namespace geo_grid
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Fixed global grid over integer 1e-7 degree positions, shared by the
+// offline spatial indexes. Rows count up from the south pole and columns
+// from the antimeridian; a cell key is row * columns + column, so one row
+// of cells is one contiguous key range.
+namespace geo_grid {
+
+static constexpr int32_t kMinCellE7{10000}; // keeps every key in 32 bits
+
+uint32_t columns(int32_t cell_e7);
+uint32_t row(int32_t lat, int32_t cell_e7);
+uint32_t column(int32_t lon, int32_t cell_e7);
+
+inline uint32_t key(uint32_t row, uint32_t column, int32_t cell_e7)
+{
+    return row * columns(cell_e7) + column;
+}
+
+inline int32_t clampLat(int64_t lat)
+{
+    return static_cast<int32_t>(lat < -900000000 ? -900000000 : lat > 900000000 ? 900000000 : lat);
+}
+
+inline int32_t clampLon(int64_t lon)
+{
+    return static_cast<int32_t>(lon < -1800000000 ? -1800000000 : lon > 1800000000 ? 1800000000 : lon);
+}
+
+} // namespace geo_grid
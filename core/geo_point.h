@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// A position exactly as the receiver reports it. Latitude and longitude stay
+// integer 1e-7 degrees from the wire to storage; the NAV-HPPOSLLH residuals
+// ride along when the receiver provides them. Convert to double only where
+// the math needs it (geodesy kernels, export).
+struct GeoPoint {
+    int32_t lat{};          // 1e-7 degrees
+    int32_t lon{};          // 1e-7 degrees
+    int32_t height{};       // mm above ellipsoid
+    int32_t height_msl{};   // mm
+    int8_t lat_hp{};        // 1e-9 degrees, -99..99
+    int8_t lon_hp{};        // 1e-9 degrees, -99..99
+    int8_t height_hp{};     // 0.1 mm, -9..9
+    int8_t height_msl_hp{}; // 0.1 mm, -9..9
+
+    static constexpr double kDegreesPerUnit{1e-7};
+    static constexpr double kDegreesPerHpUnit{1e-9};
+
+    double latitudeDegrees() const { return lat * kDegreesPerUnit + lat_hp * kDegreesPerHpUnit; }
+    double longitudeDegrees() const { return lon * kDegreesPerUnit + lon_hp * kDegreesPerHpUnit; }
+    double heightMeters() const { return height * 1e-3 + height_hp * 1e-4; }
+    double heightMslMeters() const { return height_msl * 1e-3 + height_msl_hp * 1e-4; }
+
+    bool operator==(const GeoPoint&) const = default;
+};
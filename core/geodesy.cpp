@@ -0,0 +1,49 @@
+#include "geodesy.h"
+
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+namespace geodesy {
+
+std::array<double, 3> geodetic2Ned(const GeoPoint& from, const GeoPoint& to)
+{
+    constexpr double deg2rad =
+        boost::math::constants::pi<double>() / 180.0;
+
+    // WGS-84
+    constexpr double a = 6378137.0;                // semi-major axis (m)
+    constexpr double f = 1.0 / 298.257223563;      // flattening.
+    constexpr double e2 = f * (2.0 - f);           // eccentricity²
+
+    // difference the integers first so nearby points keep every bit
+    const double d_lat = ((static_cast<int64_t>(to.lat) - from.lat) * GeoPoint::kDegreesPerUnit
+                          + (to.lat_hp - from.lat_hp) * GeoPoint::kDegreesPerHpUnit) * deg2rad;
+    const double d_lon = ((static_cast<int64_t>(to.lon) - from.lon) * GeoPoint::kDegreesPerUnit
+                          + (to.lon_hp - from.lon_hp) * GeoPoint::kDegreesPerHpUnit) * deg2rad;
+
+    const double lat1 = from.latitudeDegrees() * deg2rad;
+    const double h1 = from.heightMeters();
+    const double h2 = to.heightMeters();
+
+    const double sin_lat = std::sin(lat1);
+    const double cos_lat = std::cos(lat1);
+
+    const double w  = std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+    const double Rn = a / w;
+    const double Rm = a * (1.0 - e2) / (w * w * w);
+
+    return {
+        d_lat * (Rm + h1),              // North
+        d_lon * (Rn + h1) * cos_lat,    // East
+        -(h2 - h1)                      // Down
+    };
+}
+
+double horizontalDistance(const GeoPoint& from, const GeoPoint& to)
+{
+    const auto ned = geodetic2Ned(from, to);
+    return std::hypot(ned[0], ned[1]);
+}
+
+} // namespace geodesy
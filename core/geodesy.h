@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+
+#include "geo_point.h"
+
+namespace geodesy {
+
+// arc length of 1e-7 degree on a sphere of the mean earth radius; good
+// enough to compare and threshold distances over a few kilometers
+static constexpr double kMetersPerE7{6371008.8 * 3.14159265358979323846 / 180.0 * 1e-7};
+
+// North/east/down offset in meters of point 2 from point 1, using the local
+// WGS-84 radii of curvature at point 1. Accurate for the short baselines the
+// HUD deals with. Evaluated in double: a float cannot hold 1e-7 degrees at
+// longitudes past a few degrees.
+std::array<double, 3> geodetic2Ned(const GeoPoint& from, const GeoPoint& to);
+
+// ground distance in meters, ignoring the height change
+double horizontalDistance(const GeoPoint& from, const GeoPoint& to);
+
+} // namespace geodesy
@@ -0,0 +1,48 @@
+#include "gnss_pvt.h"
+
+#include <cmath>
+
+#include "devices/ublox_parser.h"
+
+void updateGnssPvt(const UbloxParser& parser, GnssPvt& state) {
+
+    static constexpr float mm_to_m = 1e-3;
+    static constexpr float meters_per_sec_to_miles_per_hour = 2.23694;
+    static constexpr uint32_t milliseconds_in_week = 604800000U;
+    state.position = parser.position();
+    state.height_ellipsoid = static_cast<float>(state.position.heightMeters());
+    state.height_msl = static_cast<float>(state.position.heightMslMeters());
+    state.velocity_n = parser.velocity_n() * mm_to_m;
+    state.velocity_e = parser.velocity_e() * mm_to_m;
+    state.velocity_d = parser.velocity_d() * mm_to_m;
+
+    state.velocity_2d = std::sqrt(std::pow(state.velocity_n, 2) + std::pow(state.velocity_e, 2));
+    state.velocity_3d = std::sqrt(std::pow(state.velocity_n, 2) + std::pow(state.velocity_e, 2) + std::pow(state.velocity_d, 2) );
+
+    state.sog_mph = state.velocity_2d * meters_per_sec_to_miles_per_hour;
+    state.heading = parser.heading();
+    state.gps_tow_ms = parser.itow(); 
+    const uint64_t time_since_epoch{2407 * milliseconds_in_week};
+    std::chrono::gps_time<std::chrono::milliseconds> gps_t(std::chrono::milliseconds(state.gps_tow_ms + time_since_epoch));
+    
+    state.utc_time = std::chrono::gps_clock::to_utc(gps_t);
+    state.num_sv = parser.numSv();
+    state.utc_datetime = parser.utcDateTime(); 
+    state.cardinal_direction = degreesToCardinal(state.heading);
+
+    state.differential_mode = parser.differentialMode(); 
+    state.correction_age = parser.correctionAge();
+
+}
+
+std::string degreesToCardinal(const float degrees) {
+    static const std::array<std::string, 8> directions = {
+        "N", "NE", "E", "SE", "S", "SW", "W", "NW"
+    };
+
+    constexpr float sector = 360 / directions.size(); // 45 degrees
+
+    // offset by half the sector so boundaries map correctly 
+    uint8_t index = static_cast<uint8_t>((degrees + sector / 2.0) / sector) % directions.size();
+    return directions[index];
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "geo_point.h"
+
+class UbloxParser;
+
+class GnssPvt {
+    public:
+    GeoPoint position; // integer, see GeoPoint
+    float height_ellipsoid; // meters
+    float height_msl; // meters
+    float velocity_n; // meters per second
+    float velocity_e; // meters per second
+    float velocity_d; // meters per second
+    float velocity_2d; // meters per second
+    float velocity_3d; // meters per second
+
+    float sog_mph; // miles per hour
+    float heading; // degrees 
+    std::string cardinal_direction; 
+
+    uint32_t gps_tow_ms;
+    std::chrono::utc_time<std::chrono::milliseconds> utc_time;
+    std::array<uint16_t, 6> utc_datetime;
+
+    uint8_t num_sv;
+    uint8_t correction_age; 
+    std::string differential_mode; 
+
+
+};
+
+// fills the derived solution from the parser's latest messages
+void updateGnssPvt(const UbloxParser& parser, GnssPvt& state);
+
+std::string degreesToCardinal(const float degrees);
@@ -0,0 +1,115 @@
+#include "heading_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t kMillisecondsInWeek{604800000U};
+constexpr double kDegToRad{M_PI / 180.0};
+constexpr float kSectorDeg{45.0f};
+constexpr uint8_t kSectors{8U};
+
+} // namespace
+
+HeadingFilter::Sample HeadingFilter::fromNavPvt(const UbxNavPvtMsg& pvt)
+{
+    Sample s;
+    s.itow = pvt.itow.value();
+    s.accuracy = pvt.heading_acc.value() * 1e-5f;
+    s.speed_mps = pvt.ground_speed.value() * 1e-3f;
+    s.valid = pvt.flags.gnss_fix_ok && pvt.fix_type >= 2U;
+    if (pvt.flags.head_veh_valid)
+    {
+        s.heading = pvt.heading_vehicle.value() * 1e-5f;
+        s.needs_motion = false;
+    }
+    else
+    {
+        s.heading = pvt.heading_motion.value() * 1e-5f;
+    }
+    return s;
+}
+
+const HeadingFilter::Output& HeadingFilter::update(const Sample& sample)
+{
+    // a refinement of the epoch already in: undo that one first
+    if (state_.fed && sample.itow == state_.itow)
+        state_ = before_;
+    before_ = state_;
+
+    double decay = 1.0;
+    if (state_.fed)
+    {
+        const uint32_t dt_ms = (sample.itow + kMillisecondsInWeek - state_.itow) % kMillisecondsInWeek;
+        decay = dt_ms > config_.max_gap_ms ? 0.0 : std::exp(-(dt_ms * 1e-3) / config_.time_constant_s);
+    }
+    state_.itow = sample.itow;
+    state_.fed = true;
+
+    // the direction of the sum survives the decay, only its weight fades;
+    // a long hold so leaves little for fresh samples to argue with
+    state_.sum_sin *= decay;
+    state_.sum_cos *= decay;
+    state_.sum_weight *= decay;
+
+    Output& out = state_.output;
+    const bool moving = !sample.needs_motion || sample.speed_mps >= config_.hold_speed_mps;
+    if (!sample.valid || !moving || !(sample.accuracy < config_.max_accuracy_deg))
+    {
+        out.holding = true;
+        return out;
+    }
+
+    const double accuracy = std::max(sample.accuracy, config_.min_accuracy_deg);
+    double weight = 1.0 / (accuracy * accuracy);
+    if (sample.needs_motion)
+    {
+        const double v2 = static_cast<double>(sample.speed_mps) * sample.speed_mps;
+        const double ref2 = static_cast<double>(config_.reference_speed_mps) * config_.reference_speed_mps;
+        weight *= v2 / (v2 + ref2);
+    }
+
+    const double angle = sample.heading * kDegToRad;
+    state_.sum_sin += weight * std::sin(angle);
+    state_.sum_cos += weight * std::cos(angle);
+    state_.sum_weight += weight;
+
+    const double resultant = std::hypot(state_.sum_sin, state_.sum_cos);
+    if (resultant <= 0.0)
+    {
+        // exact opposites cancelled; keep what was shown
+        out.holding = true;
+        return out;
+    }
+
+    double heading = std::atan2(state_.sum_sin, state_.sum_cos) / kDegToRad;
+    if (heading < 0.0)
+        heading += 360.0;
+    const double r = std::min(resultant / state_.sum_weight, 1.0);
+
+    out.sector = sectorOf(static_cast<float>(heading), out.valid, out.sector);
+    out.heading = heading >= 360.0 ? 0.0f : static_cast<float>(heading);
+    out.spread = static_cast<float>(std::sqrt(-2.0 * std::log(r)) / kDegToRad);
+    out.valid = true;
+    out.holding = false;
+    return out;
+}
+
+void HeadingFilter::reset()
+{
+    state_ = State{};
+    before_ = State{};
+}
+
+uint8_t HeadingFilter::sectorOf(float heading, bool have_previous, uint8_t previous) const
+{
+    if (have_previous)
+    {
+        // stay until clearly past the edge of the sector shown
+        const float off = std::fabs(std::remainder(heading - previous * kSectorDeg, 360.0f));
+        if (off <= kSectorDeg / 2.0f + config_.sector_hysteresis_deg)
+            return previous;
+    }
+    return static_cast<uint8_t>(static_cast<int>(std::floor(heading / kSectorDeg + 0.5f)) % kSectors);
+}
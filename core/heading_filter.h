@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include "devices/ubx_types.h"
+
+// Smooths the displayed heading. Each epoch's heading is added to a
+// decaying sum of unit vectors, weighted by 1 / accuracy^2 and, for heading
+// of motion, by how far the speed is above walking pace; the circular mean
+// of that sum is the output. Below the hold speed heading of motion is
+// noise and the last value is held. The cardinal sector only changes once
+// the heading is a few degrees past the boundary.
+//
+// A vehicle heading (head_veh_valid) or a dual antenna heading needs no
+// motion and is used when stopped too.
+//
+// Constant work per epoch. Feeding the same itow again replaces that
+// epoch's sample, for refinements that trail the NAV-PVT.
+class HeadingFilter {
+    public:
+    struct Config {
+        float time_constant_s{0.3f};
+        float hold_speed_mps{0.8f};      // slower: hold heading of motion
+        float reference_speed_mps{2.5f}; // at this speed a sample counts half
+        float min_accuracy_deg{0.5f};    // better is not trusted further
+        float max_accuracy_deg{45.0f};   // worse is ignored
+        float sector_hysteresis_deg{6.0f};
+        uint32_t max_gap_ms{3000U};      // longer starts the mean afresh
+    };
+
+    struct Sample {
+        uint32_t itow{};
+        float heading{};  // degrees
+        float accuracy{}; // degrees
+        float speed_mps{};
+        bool valid{};
+        bool needs_motion{true}; // heading of motion, meaningless when stopped
+    };
+
+    struct Output {
+        bool valid{};
+        bool holding{};   // the last sample was not used
+        float heading{};  // degrees, [0, 360)
+        float spread{};   // degrees, circular deviation of the mean
+        uint8_t sector{}; // 0 = N, clockwise in 45 degree steps
+    };
+
+    HeadingFilter() = default;
+    explicit HeadingFilter(Config config) : config_(config) {}
+
+    // heading of vehicle when the receiver has one, else heading of motion
+    static Sample fromNavPvt(const UbxNavPvtMsg& pvt);
+
+    const Output& update(const Sample& sample);
+    void reset();
+
+    const Output& output() const { return state_.output; }
+
+    private:
+    struct State {
+        double sum_sin{};
+        double sum_cos{};
+        double sum_weight{};
+        uint32_t itow{};
+        bool fed{};
+        Output output{};
+    };
+
+    Config config_;
+    State state_;
+    State before_; // as it was before the latest itow, to replay it
+
+    uint8_t sectorOf(float heading, bool have_previous, uint8_t previous) const;
+};
@@ -0,0 +1,101 @@
+#include "history_pyramid.h"
+
+#include <algorithm>
+
+HistoryPyramid::HistoryPyramid()
+    : HistoryPyramid(Config{})
+{
+}
+
+HistoryPyramid::HistoryPyramid(Config config)
+    : config_(config)
+{
+    config_.base_period_ms = std::max<int64_t>(config_.base_period_ms, 1);
+    config_.levels = std::clamp<size_t>(config_.levels, 1U, 32U);
+    config_.capacity = std::max<size_t>(config_.capacity, 2U);
+    buckets_.resize(config_.levels * config_.capacity);
+}
+
+void HistoryPyramid::add(int64_t time_ms, const Values& values)
+{
+    if (time_ms < 0)
+        return;
+
+    const int64_t base_index = time_ms / config_.base_period_ms;
+    for (size_t level = 0; level < config_.levels; ++level) {
+        const int64_t index = base_index >> level;
+        Bucket& bucket = slot(level, index);
+        if (bucket.index != index) {
+            // the slot last held a bucket one ring length ago
+            if (bucket.index > index)
+                continue;
+            bucket.index = index;
+            bucket.count = 0U;
+            bucket.min = values;
+            bucket.max = values;
+        }
+        for (size_t c = 0; c < kChannelCount; ++c) {
+            bucket.min[c] = std::min(bucket.min[c], values[c]);
+            bucket.max[c] = std::max(bucket.max[c], values[c]);
+        }
+        ++bucket.count;
+    }
+}
+
+void HistoryPyramid::clear()
+{
+    std::fill(buckets_.begin(), buckets_.end(), Bucket{});
+}
+
+void HistoryPyramid::query(int64_t from_ms, int64_t to_ms, size_t max_points, Window& out) const
+{
+    out.buckets.clear();
+    out.bucket_ms = config_.base_period_ms;
+    if (to_ms < from_ms || max_points == 0U)
+        return;
+
+    from_ms = std::max<int64_t>(from_ms, 0);
+    to_ms = std::max<int64_t>(to_ms, 0);
+    max_points = std::min(max_points, config_.capacity);
+
+    // finest level that fits the window
+    size_t level = 0U;
+    int64_t first = from_ms / config_.base_period_ms;
+    int64_t last = to_ms / config_.base_period_ms;
+    while (level + 1U < config_.levels && static_cast<size_t>(last - first + 1) > max_points) {
+        ++level;
+        first >>= 1;
+        last >>= 1;
+    }
+    // what the ring no longer holds is a gap either way
+    first = std::max(first, last - static_cast<int64_t>(config_.capacity) + 1);
+
+    // still too fine at the top: merge groups of buckets there, aligned to
+    // their width so the groups don't shift while the window pans
+    const int64_t count = last - first + 1;
+    int64_t group = (count + static_cast<int64_t>(max_points) - 1) / static_cast<int64_t>(max_points);
+    while (static_cast<size_t>(last / group - first / group + 1) > max_points)
+        ++group;
+
+    out.bucket_ms = (config_.base_period_ms << level) * group;
+    out.buckets.reserve(static_cast<size_t>(last / group - first / group + 1));
+    for (int64_t g = first / group; g <= last / group; ++g) {
+        Bucket merged;
+        merged.index = g;
+        for (int64_t index = std::max(g * group, first); index <= std::min(g * group + group - 1, last); ++index) {
+            const Bucket& bucket = slot(level, index);
+            if (bucket.index != index || bucket.count == 0U)
+                continue;
+            if (merged.count == 0U) {
+                merged.min = bucket.min;
+                merged.max = bucket.max;
+            }
+            for (size_t c = 0; c < kChannelCount; ++c) {
+                merged.min[c] = std::min(merged.min[c], bucket.min[c]);
+                merged.max[c] = std::max(merged.max[c], bucket.max[c]);
+            }
+            merged.count += bucket.count;
+        }
+        out.buckets.push_back(merged);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ride history for charting, kept as a pyramid of time buckets. Level k
+// buckets span base_period << k and hold the min and max of every channel
+// over that span; each level is a ring of the same length, so the finer
+// levels cover the last minutes and the coarser ones the last hours.
+//
+// Every sample updates one bucket per level, and a query reads from the
+// level whose buckets are just wide enough to fit the window into the
+// requested point count, merging buckets of the top level if it has to.
+// Both are independent of how long the ride is.
+//
+// Not thread-safe; the owner locks.
+class HistoryPyramid {
+    public:
+    enum Channel : size_t {
+        kSpeed,
+        kAltitude,
+        kSatellites,
+        kChannelCount,
+    };
+    using Values = std::array<float, kChannelCount>;
+
+    struct Config {
+        int64_t base_period_ms{100}; // one or a few epochs
+        size_t levels{9U};           // top level: 25.6 s buckets, a day of them
+        size_t capacity{4096U};      // buckets per level
+    };
+
+    struct Bucket {
+        int64_t index{-1}; // start time / bucket width
+        uint32_t count{};  // samples; 0 is a gap
+        Values min{};
+        Values max{};
+    };
+
+    struct Window {
+        int64_t bucket_ms{};
+        std::vector<Bucket> buckets; // consecutive, gaps included, oldest first
+    };
+
+    HistoryPyramid();
+    explicit HistoryPyramid(Config config);
+
+    // times must not go backwards by more than a bucket
+    void add(int64_t time_ms, const Values& values);
+    void clear();
+
+    // [from_ms, to_ms] in at most max_points buckets; where even the
+    // coarsest level is too fine, adjacent buckets of it are merged
+    void query(int64_t from_ms, int64_t to_ms, size_t max_points, Window& out) const;
+
+    size_t memoryBytes() const { return buckets_.size() * sizeof(Bucket); }
+
+    private:
+    Config config_;
+    std::vector<Bucket> buckets_; // level after level
+
+    Bucket& slot(size_t level, int64_t index) { return buckets_[level * config_.capacity + index % config_.capacity]; }
+    const Bucket& slot(size_t level, int64_t index) const
+    {
+        return buckets_[level * config_.capacity + index % config_.capacity];
+    }
+};
@@ -0,0 +1,25 @@
+#include "odometer.h"
+
+#include "geodesy.h"
+
+void Odometer::update(const UbxNavPvtMsg& pvt)
+{
+    if (!pvt.flags.gnss_fix_ok || pvt.fix_type < kMinFixType)
+    {
+        have_last_ = false;
+        return;
+    }
+
+    const GeoPoint p{pvt.lat.value(), pvt.lon.value(), pvt.height.value(), pvt.height_msl.value()};
+    if (have_last_ && pvt.ground_speed.value() >= kMinGroundSpeedMmps)
+        meters_ += geodesy::horizontalDistance(last_, p);
+
+    last_ = p;
+    have_last_ = true;
+}
+
+void Odometer::reset()
+{
+    have_last_ = false;
+    meters_ = 0.0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "devices/ubx_types.h"
+#include "geo_point.h"
+
+// Distance travelled, integrated from consecutive NAV-PVT positions. The
+// positions are differenced as integers, so the sum does not depend on how
+// far from the origin of the coordinate system the ride happens.
+class Odometer {
+    public:
+    // feed every NAV-PVT epoch
+    void update(const UbxNavPvtMsg& pvt);
+    void reset();
+    // forget the last position, e.g. after switching to another antenna
+    void restartSegment() { have_last_ = false; }
+
+    double meters() const { return meters_; }
+
+    private:
+    // below this the solution wanders while parked; don't count it
+    static constexpr int32_t kMinGroundSpeedMmps{1000};
+    static constexpr uint8_t kMinFixType{2U};
+
+    GeoPoint last_{};
+    bool have_last_{};
+    double meters_{};
+};
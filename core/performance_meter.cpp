@@ -0,0 +1,381 @@
+#include "performance_meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "track/track_format.h"
+
+namespace perf {
+
+bool appendRun(const std::filesystem::path& path, const Run& run)
+{
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+    const bool fresh = !std::filesystem::exists(path, ec);
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open())
+        return false;
+
+    if (fresh)
+        out << "# kind,start_unix_ms,0-30_s,0-60_s,quarter_s,quarter_mph,60-0_s,60-0_m,max_mph,"
+               "uncertainty_ms,epoch_ms,clean\n";
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s,%lld,%.3f,%.3f,%.3f,%.1f,%.3f,%.2f,%.1f,%.1f,%.1f,%d\n",
+                  run.kind == RunKind::kLaunch ? "launch" : "braking", static_cast<long long>(run.start_unix_ms),
+                  run.zero_to_30_s, run.zero_to_60_s, run.quarter_mile_s, run.quarter_mile_mph, run.sixty_to_zero_s,
+                  run.sixty_to_zero_m, run.max_mph, run.uncertainty_ms, run.epoch_interval_ms, run.clean ? 1 : 0);
+    out << line;
+    out.flush();
+    return out.good();
+}
+
+std::vector<Run> loadRuns(const std::filesystem::path& path)
+{
+    std::vector<Run> runs;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        std::string kind;
+        int clean = 0;
+        Run run;
+        fields >> kind >> run.start_unix_ms >> run.zero_to_30_s >> run.zero_to_60_s >> run.quarter_mile_s >>
+            run.quarter_mile_mph >> run.sixty_to_zero_s >> run.sixty_to_zero_m >> run.max_mph >>
+            run.uncertainty_ms >> run.epoch_interval_ms >> clean;
+        if (!fields || (kind != "launch" && kind != "braking"))
+            continue;
+        run.kind = kind == "launch" ? RunKind::kLaunch : RunKind::kBraking;
+        run.clean = clean != 0;
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+} // namespace perf
+
+PerformanceMeter::PerformanceMeter()
+    : PerformanceMeter(Config{})
+{
+}
+
+PerformanceMeter::PerformanceMeter(Config config)
+    : config_(std::move(config))
+{
+}
+
+void PerformanceMeter::update(const UbxNavPvtMsg& pvt)
+{
+    // the store is read here rather than at construction, on the thread
+    // that feeds epochs and off the path to the first frame
+    if (!loaded_) {
+        loaded_ = true;
+        if (!config_.store.empty()) {
+            for (const perf::Run& run : perf::loadRuns(config_.store)) {
+                runs_.push_back(run);
+                if (runs_.size() > config_.kept_runs)
+                    runs_.pop_front();
+            }
+            if (!runs_.empty()) {
+                status_.last = runs_.back();
+                status_.have_last = true;
+            }
+            refreshBest();
+        }
+    }
+
+    const Sample s = sample(pvt);
+    if (have_last_ && s.t_ms <= last_.t_ms)
+        return;
+
+    if (have_last_ && s.t_ms - last_.t_ms > config_.max_epoch_gap_ms) {
+        // nothing can be interpolated across a hole this size
+        if (status_.state == State::kLaunch)
+            finish(run_, start_ms_, static_cast<double>(last_.t_ms), run_epochs_, run_.zero_to_30_s > 0.0f);
+        status_.state = State::kIdle;
+        braking_ = false;
+        above_sixty_ = false;
+        standstill_since_ms_ = -1;
+    } else if (have_last_) {
+        updateLaunch(s, pvt);
+        updateBraking(s, pvt);
+    }
+
+    last_ = s;
+    have_last_ = true;
+    status_.braking = braking_;
+    status_.elapsed_s = status_.state == State::kLaunch ? static_cast<float>((s.t_ms - start_ms_) * 1e-3) : 0.0f;
+    status_.runs = runs_.size();
+}
+
+PerformanceMeter::Sample PerformanceMeter::sample(const UbxNavPvtMsg& pvt)
+{
+    const uint32_t itow = pvt.itow.value();
+    if (have_last_ && itow < last_itow_ && last_itow_ - itow > kMillisecondsInWeek / 2)
+        week_offset_ms_ += kMillisecondsInWeek;
+    last_itow_ = itow;
+
+    Sample s;
+    s.t_ms = week_offset_ms_ + itow;
+    s.v = pvt.ground_speed.value() * 1e-3f;
+    s.acc = pvt.speed_acc.value() * 1e-3f;
+    s.ok = pvt.flags.gnss_fix_ok && pvt.fix_type >= 2U && pvt.fix_type <= 4U && s.acc <= config_.max_speed_acc_mps;
+    return s;
+}
+
+void PerformanceMeter::updateLaunch(const Sample& s, const UbxNavPvtMsg& pvt)
+{
+    if (status_.state == State::kLaunch) {
+        refineStart(s);
+        ++run_epochs_;
+        run_.clean = run_.clean && s.ok;
+
+        const double before_m = distance_m_;
+        distance_m_ += distanceWithin(last_, s, static_cast<double>(s.t_ms - last_.t_ms));
+        run_.max_mph = std::max(run_.max_mph, s.v / kMetersPerSecondPerMph);
+
+        for (auto [target_mph, result] : {std::pair{30.0f, &run_.zero_to_30_s}, std::pair{60.0f, &run_.zero_to_60_s}}) {
+            if (*result > 0.0f)
+                continue;
+            const Crossing c = crossing(s, target_mph * kMetersPerSecondPerMph);
+            if (c.found && s.v > last_.v) {
+                *result = static_cast<float>((c.t_ms - start_ms_) * 1e-3);
+                run_.uncertainty_ms = std::max(run_.uncertainty_ms, c.uncertainty_ms);
+            }
+        }
+
+        if (run_.quarter_mile_s == 0.0f && distance_m_ >= kQuarterMileM) {
+            // constant acceleration over the epoch: solve v0 t + a t^2 / 2 = remaining
+            const double dt = static_cast<double>(s.t_ms - last_.t_ms);
+            const double a = (s.v - last_.v) / dt * 1e-3; // m per ms^2
+            const double b = last_.v * 1e-3;              // m per ms
+            const double remaining = kQuarterMileM - before_m;
+            double tau = std::abs(a) < 1e-12 ? remaining / std::max(b, 1e-9)
+                                             : (-b + std::sqrt(std::max(b * b + 2.0 * a * remaining, 0.0))) / a;
+            tau = std::clamp(tau, 0.0, dt);
+            run_.quarter_mile_s = static_cast<float>((last_.t_ms + tau - start_ms_) * 1e-3);
+            run_.quarter_mile_mph = static_cast<float>((last_.v + (s.v - last_.v) * tau / dt) / kMetersPerSecondPerMph);
+        }
+
+        const bool done = run_.zero_to_60_s > 0.0f && run_.quarter_mile_s > 0.0f;
+        const bool backed_off = s.v < run_.max_mph * kMetersPerSecondPerMph - config_.back_off_mps;
+        const bool too_long = s.t_ms - start_ms_ > config_.max_run_ms;
+        if (done || backed_off || too_long || s.v < config_.standstill_mps) {
+            finish(run_, start_ms_, static_cast<double>(s.t_ms), run_epochs_, run_.zero_to_30_s > 0.0f);
+            status_.state = State::kIdle;
+            standstill_since_ms_ = -1;
+        }
+        return;
+    }
+
+    if (!s.ok) {
+        status_.state = State::kIdle;
+        standstill_since_ms_ = -1;
+        return;
+    }
+
+    if (s.v < config_.standstill_mps) {
+        if (standstill_since_ms_ < 0)
+            standstill_since_ms_ = s.t_ms;
+        if (s.t_ms - standstill_since_ms_ >= config_.standstill_hold_ms)
+            status_.state = State::kArmed;
+        return;
+    }
+
+    // rolling: armed stays armed through the first slow epochs of a launch
+    standstill_since_ms_ = -1;
+    if (status_.state != State::kArmed)
+        return;
+
+    if (last_.v < config_.standstill_mps) {
+        // the bike left standstill in this epoch; where exactly is only
+        // known once the next epoch gives the acceleration, see refineStart
+        first_moving_ = s;
+        start_refined_ = false;
+        // the chord from the last slow epoch is the earliest it can have been
+        const double slope = (s.v - last_.v) / static_cast<double>(s.t_ms - last_.t_ms);
+        const double previous_ms = static_cast<double>(last_.t_ms);
+        start_ms_ = slope > 0.0 ? std::max(previous_ms - last_.v / slope, previous_ms - (s.t_ms - previous_ms)) : previous_ms;
+        earliest_start_ms_ = start_ms_;
+        distance_m_ = 0.5 * s.v * (s.t_ms - start_ms_) * 1e-3;
+        run_epochs_ = 1U;
+    } else {
+        refineStart(s);
+        distance_m_ += distanceWithin(last_, s, static_cast<double>(s.t_ms - last_.t_ms));
+        ++run_epochs_;
+    }
+
+    if (s.v >= config_.launch_mps)
+        startLaunch(s, pvt);
+}
+
+void PerformanceMeter::refineStart(const Sample& s)
+{
+    if (start_refined_)
+        return;
+    start_refined_ = true;
+
+    // the epoch before the first moving one may still have been at zero,
+    // so the chord from it starts too early. Run the acceleration of the
+    // first two moving epochs back to zero instead.
+    const double dt = static_cast<double>(s.t_ms - first_moving_.t_ms);
+    const double slope = dt > 0.0 ? (s.v - first_moving_.v) / dt : 0.0;
+    if (slope <= 0.0)
+        return;
+
+    const double start_ms = std::clamp(first_moving_.t_ms - first_moving_.v / slope, earliest_start_ms_,
+                                       static_cast<double>(first_moving_.t_ms));
+    // constant acceleration from rest up to the first moving epoch
+    distance_m_ += 0.5 * first_moving_.v * (start_ms_ - start_ms) * 1e-3;
+    if (status_.state == State::kLaunch)
+        run_.start_unix_ms += static_cast<int64_t>(std::llround(start_ms - start_ms_));
+    start_ms_ = start_ms;
+}
+
+void PerformanceMeter::startLaunch(const Sample& s, const UbxNavPvtMsg& pvt)
+{
+    run_ = perf::Run{};
+    run_.kind = perf::RunKind::kLaunch;
+    run_.start_unix_ms = track::fromNavPvt(pvt).time_ms - static_cast<int64_t>(s.t_ms - start_ms_);
+    run_.max_mph = s.v / kMetersPerSecondPerMph;
+    run_.clean = s.ok && last_.ok;
+    status_.state = State::kLaunch;
+}
+
+void PerformanceMeter::updateBraking(const Sample& s, const UbxNavPvtMsg& pvt)
+{
+    const float sixty_mps = 60.0f * kMetersPerSecondPerMph;
+    const double dt = static_cast<double>(s.t_ms - last_.t_ms);
+
+    if (!braking_) {
+        if (s.v >= sixty_mps) {
+            above_sixty_ = true;
+            return;
+        }
+        const Crossing c = crossing(s, sixty_mps);
+        if (!above_sixty_ || !c.found)
+            return;
+
+        braking_ = true;
+        above_sixty_ = false;
+        brake_ = perf::Run{};
+        brake_.kind = perf::RunKind::kBraking;
+        brake_.max_mph = last_.v / kMetersPerSecondPerMph;
+        brake_.uncertainty_ms = c.uncertainty_ms;
+        brake_.clean = s.ok && last_.ok;
+        brake_start_ms_ = c.t_ms;
+        brake_.start_unix_ms = track::fromNavPvt(pvt).time_ms - static_cast<int64_t>(s.t_ms - c.t_ms);
+        brake_distance_m_ = distanceWithin(last_, s, dt) - distanceWithin(last_, s, c.t_ms - last_.t_ms);
+        brake_decel_ = (last_.v - s.v) / dt;
+        brake_epochs_ = 1U;
+        return;
+    }
+
+    ++brake_epochs_;
+    brake_.clean = brake_.clean && s.ok;
+
+    if (s.v >= sixty_mps) {
+        // back on the throttle, not a stop
+        braking_ = false;
+        above_sixty_ = true;
+        return;
+    }
+
+    if (s.v <= config_.standstill_mps) {
+        // receivers hold zero once stopped, so the line into this epoch
+        // reaches zero late; carry on at the previous epoch's deceleration
+        const double chord = (last_.v - s.v) / dt; // m/s per ms
+        const double decel = brake_decel_ > 0.0 ? brake_decel_ : chord;
+        double tau = dt;
+        if (decel > 0.0) {
+            tau = std::clamp(last_.v / decel, 0.0, dt + s.v / decel);
+            brake_.uncertainty_ms = std::max(brake_.uncertainty_ms, static_cast<float>(std::max(s.acc, last_.acc) / decel));
+        }
+        brake_distance_m_ += 0.5 * last_.v * tau * 1e-3;
+        const double end_ms = last_.t_ms + tau;
+
+        brake_.sixty_to_zero_s = static_cast<float>((end_ms - brake_start_ms_) * 1e-3);
+        brake_.sixty_to_zero_m = static_cast<float>(brake_distance_m_);
+        braking_ = false;
+        finish(brake_, brake_start_ms_, end_ms, brake_epochs_, true);
+        return;
+    }
+
+    brake_distance_m_ += distanceWithin(last_, s, dt);
+    brake_decel_ = (last_.v - s.v) / dt;
+    if (s.t_ms - brake_start_ms_ > config_.max_braking_ms)
+        braking_ = false; // slowed down, never stopped
+}
+
+void PerformanceMeter::finish(perf::Run& run, double start_ms, double end_ms, uint32_t epochs, bool keep)
+{
+    if (!keep)
+        return;
+
+    run.epoch_interval_ms = static_cast<float>((end_ms - start_ms) / std::max<uint32_t>(epochs, 1U));
+
+    runs_.push_back(run);
+    if (runs_.size() > config_.kept_runs)
+        runs_.pop_front();
+    status_.last = run;
+    status_.have_last = true;
+    status_.runs = runs_.size();
+    refreshBest();
+
+    if (!config_.store.empty())
+        perf::appendRun(config_.store, run);
+    if (handler_)
+        handler_(run);
+}
+
+void PerformanceMeter::refreshBest()
+{
+    const auto better = [](float candidate, float best) { return candidate > 0.0f && (best == 0.0f || candidate < best); };
+
+    status_.best_zero_to_60_s = 0.0f;
+    status_.best_quarter_mile_s = 0.0f;
+    status_.best_sixty_to_zero_s = 0.0f;
+    for (const perf::Run& run : runs_) {
+        if (!run.clean)
+            continue;
+        if (better(run.zero_to_60_s, status_.best_zero_to_60_s))
+            status_.best_zero_to_60_s = run.zero_to_60_s;
+        if (better(run.quarter_mile_s, status_.best_quarter_mile_s))
+            status_.best_quarter_mile_s = run.quarter_mile_s;
+        if (better(run.sixty_to_zero_s, status_.best_sixty_to_zero_s))
+            status_.best_sixty_to_zero_s = run.sixty_to_zero_s;
+    }
+}
+
+PerformanceMeter::Crossing PerformanceMeter::crossing(const Sample& s, float target) const
+{
+    Crossing c;
+    const bool up = last_.v < target && s.v >= target;
+    const bool down = last_.v > target && s.v <= target;
+    if (!up && !down)
+        return c;
+
+    const double dt = static_cast<double>(s.t_ms - last_.t_ms);
+    const double dv = s.v - last_.v;
+    c.found = true;
+    c.t_ms = last_.t_ms + (target - last_.v) / dv * dt;
+    // a speed error of acc moves the crossing by acc / acceleration
+    c.uncertainty_ms = static_cast<float>(std::max(s.acc, last_.acc) / (std::abs(dv) / dt));
+    return c;
+}
+
+double PerformanceMeter::distanceWithin(const Sample& a, const Sample& b, double tau_ms)
+{
+    const double dt = static_cast<double>(b.t_ms - a.t_ms);
+    const double slope = dt > 0.0 ? (b.v - a.v) / dt : 0.0;
+    return (a.v * tau_ms + 0.5 * slope * tau_ms * tau_ms) * 1e-3;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "devices/ubx_types.h"
+
+namespace perf {
+
+enum class RunKind : uint8_t {
+    kLaunch,  // from standstill: 0-30, 0-60, quarter mile
+    kBraking, // 60-0
+};
+
+// Times in seconds, 0 where the run never got there.
+struct Run {
+    RunKind kind{};
+    int64_t start_unix_ms{};
+    float zero_to_30_s{};
+    float zero_to_60_s{};
+    float quarter_mile_s{};
+    float quarter_mile_mph{}; // trap speed
+    float sixty_to_zero_s{};
+    float sixty_to_zero_m{};
+    float max_mph{};
+    // timing uncertainty at the worst crossing, from the receiver's speed
+    // accuracy over the acceleration there
+    float uncertainty_ms{};
+    float epoch_interval_ms{}; // mean over the run
+    // fix and speed accuracy held and no epoch went missing
+    bool clean{};
+};
+
+// appended one line per run, so a crash loses at most the run in flight
+bool appendRun(const std::filesystem::path& path, const Run& run);
+std::vector<Run> loadRuns(const std::filesystem::path& path);
+
+} // namespace perf
+
+// Times launches and stops from NAV-PVT. Threshold crossings are placed
+// between epochs by interpolating the Doppler ground speed, and distance is
+// integrated from the same speeds assuming constant acceleration across
+// each epoch, so the result does not depend on how often the UI looks and
+// resolves to a few milliseconds at 10-25 Hz.
+//
+// A launch needs a second of standstill first; it ends once 60 mph and the
+// quarter mile are both done, when the rider backs off, or after a minute.
+// Braking is timed from a downward crossing of 60 mph to a stop. Runs that
+// reach 30 mph, or a stop from 60, are kept.
+//
+// Not thread-safe; feed and read from the receive thread.
+class PerformanceMeter {
+    public:
+    struct Config {
+        float standstill_mps{0.3f};
+        uint32_t standstill_hold_ms{1000U};
+        float launch_mps{1.0f};          // armed and faster than this: a launch
+        float back_off_mps{3.0f};        // this far below the run's peak ends it
+        uint32_t max_run_ms{60000U};
+        uint32_t max_braking_ms{15000U};
+        uint32_t max_epoch_gap_ms{500U}; // longer ends the run
+        float max_speed_acc_mps{0.5f};   // worse marks the run not clean
+        size_t kept_runs{50U};
+        std::filesystem::path store;     // appended to when set
+    };
+
+    enum class State : uint8_t {
+        kIdle,
+        kArmed,
+        kLaunch,
+    };
+
+    struct Status {
+        State state{};
+        bool braking{};
+        float elapsed_s{}; // of the launch in progress
+        size_t runs{};
+        perf::Run last{};
+        bool have_last{};
+        float best_zero_to_60_s{};
+        float best_quarter_mile_s{};
+        float best_sixty_to_zero_s{};
+    };
+
+    using RunHandler = std::function<void(const perf::Run& run)>;
+
+    PerformanceMeter();
+    explicit PerformanceMeter(Config config);
+
+    // every NAV-PVT, in order; repeats of an itow are ignored
+    void update(const UbxNavPvtMsg& pvt);
+
+    void setRunHandler(RunHandler handler) { handler_ = std::move(handler); }
+    const std::deque<perf::Run>& runs() const { return runs_; }
+    const Status& status() const { return status_; }
+
+    private:
+    struct Sample {
+        int64_t t_ms{}; // itow, unwrapped across week rollovers
+        float v{};      // m/s
+        float acc{};    // m/s
+        bool ok{};
+    };
+
+    struct Crossing {
+        bool found{};
+        double t_ms{};
+        float uncertainty_ms{};
+    };
+
+    static constexpr int64_t kMillisecondsInWeek{604800000};
+    static constexpr float kMetersPerSecondPerMph{0.44704f};
+    static constexpr double kQuarterMileM{402.336};
+
+    Config config_;
+    RunHandler handler_;
+    std::deque<perf::Run> runs_;
+    Status status_;
+    bool loaded_{};
+
+    Sample last_{};
+    bool have_last_{};
+    int64_t week_offset_ms_{};
+    uint32_t last_itow_{};
+    int64_t standstill_since_ms_{-1};
+
+    // launch in progress
+    perf::Run run_{};
+    double start_ms_{};
+    double distance_m_{};
+    uint32_t run_epochs_{};
+    Sample first_moving_{};
+    double earliest_start_ms_{};
+    bool start_refined_{};
+
+    // braking in progress
+    bool above_sixty_{};
+    bool braking_{};
+    perf::Run brake_{};
+    double brake_start_ms_{};
+    double brake_distance_m_{};
+    double brake_decel_{}; // of the last epoch, m/s per ms
+    uint32_t brake_epochs_{};
+
+    Sample sample(const UbxNavPvtMsg& pvt);
+    void updateLaunch(const Sample& s, const UbxNavPvtMsg& pvt);
+    void updateBraking(const Sample& s, const UbxNavPvtMsg& pvt);
+    void refineStart(const Sample& s);
+    void startLaunch(const Sample& s, const UbxNavPvtMsg& pvt);
+    void finish(perf::Run& run, double start_ms, double end_ms, uint32_t epochs, bool keep);
+    void refreshBest();
+
+    // where the speed crossed `target` between last_ and s, if it did
+    Crossing crossing(const Sample& s, float target) const;
+    static double distanceWithin(const Sample& a, const Sample& b, double tau_ms);
+};
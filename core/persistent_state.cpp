@@ -0,0 +1,145 @@
+#include "persistent_state.h"
+
+#include <cstring>
+#include <system_error>
+
+#include <boost/crc.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace persist {
+
+uint32_t slotCrc(const Slot& slot)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(&slot.sequence, sizeof(slot.sequence));
+    crc.process_bytes(&slot.length, sizeof(slot.length));
+    crc.process_bytes(&slot.state, sizeof(slot.state));
+    return crc.checksum();
+}
+
+} // namespace persist
+
+namespace {
+
+constexpr size_t kFileSize{persist::kPageSize * (1U + persist::kSlotCount)};
+
+} // namespace
+
+PersistentState::~PersistentState()
+{
+    close();
+}
+
+bool PersistentState::open(const std::filesystem::path& path)
+{
+    close();
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 ||
+        (static_cast<size_t>(st.st_size) != kFileSize && ::ftruncate(fd, static_cast<off_t>(kFileSize)) != 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, kFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<uint8_t*>(map);
+    size_ = kFileSize;
+
+    persist::FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (header.magic != persist::kMagic || header.version != persist::kVersion ||
+        header.state_size != sizeof(persist::State)) {
+        // new, or written by another layout: nothing in it can be trusted
+        std::memset(data_, 0, size_);
+        header = persist::FileHeader{persist::kMagic, persist::kVersion, 0U, sizeof(persist::State)};
+        std::memcpy(data_, &header, sizeof(header));
+        ::msync(data_, size_, MS_SYNC);
+    }
+
+    const size_t index = newest();
+    sequence_ = index < persist::kSlotCount ? slot(index)->sequence : 0U;
+    return true;
+}
+
+void PersistentState::close()
+{
+    if (!data_)
+        return;
+
+    sync();
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0U;
+}
+
+bool PersistentState::load(persist::State& state) const
+{
+    if (!data_)
+        return false;
+
+    const size_t index = newest();
+    if (index == persist::kSlotCount)
+        return false;
+    state = slot(index)->state;
+    return true;
+}
+
+void PersistentState::save(const persist::State& state)
+{
+    if (!data_)
+        return;
+
+    // overwrite the older copy; the newer one stays intact until this
+    // one is complete
+    persist::Slot next{};
+    next.sequence = sequence_ + 1U;
+    next.length = sizeof(persist::State);
+    next.state = state;
+    next.crc = persist::slotCrc(next);
+
+    std::memcpy(slot(next.sequence % persist::kSlotCount), &next, sizeof(next));
+    sequence_ = next.sequence;
+}
+
+void PersistentState::sync()
+{
+    if (data_)
+        ::msync(data_, size_, MS_SYNC);
+}
+
+persist::Slot* PersistentState::slot(size_t index) const
+{
+    return reinterpret_cast<persist::Slot*>(data_ + persist::kPageSize * (1U + index));
+}
+
+size_t PersistentState::newest() const
+{
+    size_t best = persist::kSlotCount;
+    uint64_t best_sequence = 0U;
+    for (size_t i = 0; i < persist::kSlotCount; ++i) {
+        persist::Slot copy;
+        std::memcpy(&copy, slot(i), sizeof(copy));
+        if (copy.sequence == 0U || copy.length != sizeof(persist::State) || copy.crc != persist::slotCrc(copy))
+            continue;
+        if (copy.sequence > best_sequence) {
+            best = i;
+            best_sequence = copy.sequence;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// On-disk layout of the HUD state file (state.bin).
+//
+// A header page followed by two slots, each on its own page. A save goes to
+// the slot holding the older sequence, so the newest complete copy is never
+// the one being overwritten; a power cut mid-write leaves a slot that fails
+// its crc and the other one is used. A version change starts from nothing.
+namespace persist {
+
+static constexpr uint64_t kMagic{0x3145544154534D48ULL}; // "HMSTATE1"
+static constexpr uint16_t kVersion{1U};
+static constexpr size_t kPageSize{4096U};
+static constexpr size_t kSlotCount{2U};
+
+struct LastFix {
+    int32_t lat{}; // 1e-7 deg
+    int32_t lon{};
+    int32_t height{}; // mm above ellipsoid
+    uint32_t horizontal_acc_mm{};
+    int64_t unix_ms{};
+    float heading{};
+    uint8_t valid{};
+    std::array<uint8_t, 3> reserved{};
+};
+
+// this ride, carried across restarts that are close enough together
+struct Trip {
+    int64_t start_unix_ms{};
+    double distance_m{};
+    double moving_s{};
+    float max_mph{};
+    uint32_t reserved{};
+};
+
+struct State {
+    double odometer_m{};
+    LastFix fix{};
+    Trip trip{};
+    int32_t page{};
+    uint32_t reserved{};
+    int64_t saved_unix_ms{};
+};
+
+struct FileHeader {
+    uint64_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t state_size;
+};
+
+struct Slot {
+    uint64_t sequence; // 0 for never written
+    uint32_t length;   // of the state
+    uint32_t crc;      // crc32 of sequence, length and the state
+    State state;
+};
+
+static_assert(sizeof(Slot) <= kPageSize, "a slot must fit its page");
+
+uint32_t slotCrc(const Slot& slot);
+
+} // namespace persist
+
+// Memory mapped state file, see persist. Loading is a crc over two slots;
+// saving copies into the mapping and leaves the write back to the kernel,
+// so neither blocks on storage. sync() waits for it, for a clean shutdown.
+class PersistentState {
+    public:
+    PersistentState() = default;
+    ~PersistentState();
+
+    PersistentState(const PersistentState&) = delete;
+    PersistentState& operator=(const PersistentState&) = delete;
+
+    // creates the file when it is missing or has another layout
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    // the newest intact copy; false if there is none
+    bool load(persist::State& state) const;
+    void save(const persist::State& state);
+    void sync();
+
+    uint64_t sequence() const { return sequence_; }
+
+    private:
+    uint8_t* data_{};
+    size_t size_{};
+    uint64_t sequence_{};
+
+    persist::Slot* slot(size_t index) const;
+    // index of the newest slot whose crc holds, or kSlotCount
+    size_t newest() const;
+};
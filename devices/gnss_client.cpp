@@ -1,13 +1,38 @@
 #include "gnss_client.h"
 
-#include <cmath>
+#include <chrono>
 #include <iostream>
-#include <array>
-#include <boost/math/constants/constants.hpp>
+
+#include "core/epoch_merger.h"
+#include "ipc/gnss_shm.h"
+#include "logging/ride_logger.h"
+
+namespace {
+
+constexpr uint8_t kMinFixType{2U}; // 2D
+
+}
 
 GnssClient::GnssClient(QObject* parent)
     : QObject(parent)
+    , socket_(this) // parented so it follows moveToThread
 {
+    configurator_ = new UbxConfigurator(
+        [this](const std::vector<uint8_t>& frame) { return sendFrame(frame); }, this);
+    supervisor_ = new LinkSupervisor(
+        [this] { openLink(); },
+        [this] {
+            if (socket_.state() != QAbstractSocket::UnconnectedState)
+                socket_.abort();
+        },
+        this);
+
+    connect(&socket_, &QTcpSocket::connected,
+            this, &GnssClient::onConnected);
+
+    connect(&socket_, &QTcpSocket::disconnected,
+            this, &GnssClient::onDisconnected);
+
     connect(&socket_, &QTcpSocket::readyRead,
             this, &GnssClient::onReadyRead);
 
@@ -15,25 +40,37 @@ GnssClient::GnssClient(QObject* parent)
             QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred),
             this,
             &GnssClient::onSocketError);
+
+    ublox_parser_.setFrameHandler([this](MsgClassId id, const uint8_t* frame, size_t length) {
+        onFrame(id, frame, length);
+    });
 }
 
 void GnssClient::connectTcp(const QString& host, quint16 port)
 {
     last_error_.clear();
+    host_ = host;
+    port_ = port;
+    supervisor_->start(QString("%1:%2").arg(host).arg(port));
+}
 
-    if (socket_.state() != QAbstractSocket::UnconnectedState)
-        socket_.abort();
-
+void GnssClient::openLink()
+{
+    // the supervisor has aborted the old connection; nothing half-parsed
+    // or half-configured carries over to the new one
+    configurator_->cancel();
     ublox_parser_.reset();
     state_ = GnssPvt{};
 
-    socket_.connectToHost(host, port);
+    socket_.connectToHost(host_, port_);
 }
 
 void GnssClient::disconnect()
 {
     last_error_.clear();
 
+    supervisor_->stop();
+    configurator_->cancel();
     socket_.disconnectFromHost();
     if (socket_.state() != QAbstractSocket::UnconnectedState)
         socket_.abort();
@@ -52,93 +89,124 @@ QString GnssClient::lastErrorString() const
     return last_error_;
 }
 
-void GnssClient::onReadyRead()
+void GnssClient::setEpochMerger(EpochMerger* merger, size_t receiver)
 {
-    const QByteArray bytes = socket_.readAll();
-    if (bytes.isEmpty())
-        return;
-
-    ublox_parser_.read_bytes(bytes); 
-    updateGnssPvt();
+    merger_ = merger;
+    merger_receiver_ = receiver;
 }
 
-void GnssClient::onSocketError(QAbstractSocket::SocketError)
+void GnssClient::setAiding(const ubx::mga::Aiding& aiding)
 {
-    last_error_ = socket_.errorString();
+    aiding_ = aiding;
+    aiding_pending_ = aiding.have_position || aiding.have_time;
 }
 
-void GnssClient::updateGnssPvt() {
-
-    static constexpr float mm_to_m = 1e-3;
-    static constexpr float meters_per_sec_to_miles_per_hour = 2.23694;
-    static constexpr uint32_t milliseconds_in_week = 604800000U;
-    state_.latitude = ublox_parser_.latitude();
-    state_.longitude = ublox_parser_.longitude();
-    state_.height_msl = ublox_parser_.height_msl();
-    state_.velocity_n = ublox_parser_.velocity_n() * mm_to_m;
-    state_.velocity_e = ublox_parser_.velocity_e() * mm_to_m;
-    state_.velocity_d = ublox_parser_.velocity_d() * mm_to_m;
-
-    state_.velocity_2d = std::sqrt(std::pow(state_.velocity_n, 2) + std::pow(state_.velocity_e, 2));
-    state_.velocity_3d = std::sqrt(std::pow(state_.velocity_n, 2) + std::pow(state_.velocity_e, 2) + std::pow(state_.velocity_d, 2) );
-
-    state_.sog_mph = state_.velocity_2d * meters_per_sec_to_miles_per_hour;
-    state_.heading = ublox_parser_.heading();
-    state_.gps_tow_ms = ublox_parser_.itow(); 
-    // std::cout << "state gps time ms: " << state_.gps_tow_ms << "\n";
-    const uint64_t time_since_epoch{2407 * milliseconds_in_week};
-    std::chrono::gps_time<std::chrono::milliseconds> gps_t(std::chrono::milliseconds(state_.gps_tow_ms + time_since_epoch));
-    
-    state_.utc_time = std::chrono::gps_clock::to_utc(gps_t);
-    state_.num_sv = ublox_parser_.numSv();
-    state_.utc_datetime = ublox_parser_.utcDateTime(); 
-    state_.cardinal_direction = degreesToCardinal(state_.heading);
-
-    state_.differential_mode = ublox_parser_.differentialMode(); 
-    state_.correction_age = ublox_parser_.correctionAge();
-
+bool GnssClient::sendFrame(const std::vector<uint8_t>& frame)
+{
+    return sendBytes(frame.data(), frame.size());
 }
 
-QString GnssClient::degreesToCardinal(const float degrees) {
-    const std::array<QString, 8> directions = {
-        "N", "NE", "E", "SE", "S", "SW", "W", "NW"
-    };
-
-    constexpr float sector = 360 / directions.size(); // 45 degrees
+bool GnssClient::sendBytes(const uint8_t* data, size_t length)
+{
+    if (!isConnected())
+        return false;
 
-    // offset by half the sector so boundaries map correctly 
-    uint8_t index = static_cast<uint8_t>((degrees + sector / 2.0) / sector) % directions.size();
-    return directions[index];
+    const qint64 n = socket_.write(reinterpret_cast<const char*>(data), static_cast<qint64>(length));
+    return n == static_cast<qint64>(length);
 }
 
-std::array<float, 3> GnssClient::geodetic2Ned(float lat1, float lon1, float h1, float lat2, float lon2, float h2)
+void GnssClient::onConnected()
 {
-    constexpr float deg2rad =
-        boost::math::constants::pi<float>() / 180.0f;
+    last_error_.clear();
+    supervisor_->linkUp(steadyNowNs());
+    if (merger_)
+        merger_->setConnected(merger_receiver_, true, steadyNowNs());
+    if (aiding_pending_)
+    {
+        // later connects find the receiver running, with better than this
+        aiding_pending_ = false;
+        const std::vector<uint8_t> frames = ubx::mga::aidingFrames(aiding_, std::chrono::system_clock::now());
+        if (!frames.empty() && sendFrame(frames))
+            std::cout << "aiding sent to " << host_.toStdString() << ":" << port_ << std::endl;
+    }
+    configurator_->apply(profile_);
+}
 
-    // WGS-84
-    constexpr float a = 6378137.0f;                // semi-major axis (m)
-    constexpr float f = 1.0f / 298.257223563f;     // flattening.
-    constexpr float e2 = f * (2.0f - f);           // eccentricity²
+void GnssClient::onDisconnected()
+{
+    const int64_t now_ns = steadyNowNs();
+    if (merger_)
+        merger_->setConnected(merger_receiver_, false, now_ns);
+    supervisor_->linkDown(LinkSupervisor::Cause::kRemoteClosed, {}, now_ns);
+}
 
-     lat1 = lat1 * deg2rad;
-     lat2 = lat2 * deg2rad;
-     lon1 = lon1 * deg2rad;
-     lon2 = lon2 * deg2rad;
+void GnssClient::onReadyRead()
+{
+    const QByteArray bytes = socket_.readAll();
+    if (bytes.isEmpty())
+        return;
 
-    const float d_lat = lat2 - lat1;
-    const float d_lon = lon2 - lon1;
+    rx_time_ns_ = steadyNowNs();
+    supervisor_->bytesReceived(rx_time_ns_);
+    ublox_parser_.read_bytes(bytes);
+}
 
-    const float sin_lat = std::sin(lat1);
-    const float cos_lat = std::cos(lat1);
+void GnssClient::onSocketError(QAbstractSocket::SocketError error)
+{
+    const int64_t now_ns = steadyNowNs();
+    last_error_ = socket_.errorString();
+    // a failed connect never emits disconnected()
+    if (merger_)
+        merger_->setConnected(merger_receiver_, false, now_ns);
+    supervisor_->linkDown(LinkSupervisor::causeOf(error), last_error_, now_ns);
+}
 
-    const float w  = std::sqrt(1.0f - e2 * sin_lat * sin_lat);
-    const float Rn = a / w;
-    const float Rm = a * (1.0f - e2) / (w * w * w);
+int64_t GnssClient::steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
 
-    return {
-        d_lat * (Rm + h1),              // North
-        d_lon * (Rn + h1) * cos_lat,    // East
-        -(h2 - h1)                      // Down
-    };
-}
\ No newline at end of file
+void GnssClient::onFrame(MsgClassId id, const uint8_t* frame, size_t length)
+{
+    configurator_->handleFrame(id, frame, length);
+
+    const size_t payload_length = length - UbloxParser::kFrameOverhead;
+    const bool nav_pvt = id == MsgClassId::kUbxNavPvt && payload_length == sizeof(UbxNavPvtMsg);
+    const bool hpposllh = id == MsgClassId::kUbxNavHpposllh && payload_length == sizeof(UbxNavHpposllhMsg) &&
+                          ublox_parser_.navHpposllh().itow.value() == ublox_parser_.navPvt().itow.value();
+
+    if (nav_pvt)
+    {
+        const UbxNavPvtMsg& pvt = ublox_parser_.navPvt();
+        supervisor_->epoch(pvt.flags.gnss_fix_ok && pvt.fix_type >= kMinFixType, rx_time_ns_);
+    }
+
+    // HPPOSLLH refines the position of the NAV-PVT with the same itow
+    if (nav_pvt || hpposllh)
+    {
+        ::updateGnssPvt(ublox_parser_, state_);
+        if (merger_)
+            merger_->onEpoch(merger_receiver_, state_, ublox_parser_.navPvt(), rx_time_ns_);
+    }
+
+    if (merger_ && id == MsgClassId::kUbxNavRelposned && payload_length == sizeof(UbxNavRelposnedMsg))
+        merger_->onRelPosNed(merger_receiver_, ublox_parser_.navRelposned());
+
+    if (ride_logger_)
+    {
+        if (ride_logger_->logsRawFrames())
+            ride_logger_->logRawFrame(frame, length, rx_time_ns_);
+        if (nav_pvt)
+            ride_logger_->logEpoch(ublox_parser_.navPvt(), rx_time_ns_);
+    }
+
+    if (shm_publisher_)
+    {
+        if (shm_publisher_->publishesRawFrames())
+            shm_publisher_->publishRawFrame(frame, length, rx_time_ns_);
+        if (nav_pvt)
+            shm_publisher_->publishEpoch(ublox_parser_.navPvt(), rx_time_ns_);
+    }
+}
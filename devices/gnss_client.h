@@ -5,34 +5,16 @@
 #include <QTcpSocket>
 #include <QString>
 
+#include "core/gnss_pvt.h"
+#include "link_supervisor.h"
 #include "ublox_parser.h"
+#include "ubx_aiding.h"
+#include "ubx_config.h"
+#include "ubx_configurator.h"
 
-class GnssPvt {
-    public:
-    float latitude; // decimal degrees
-    float longitude; // decimal degrees
-    float height_ellipsoid; // meters
-    float height_msl; // meters
-    float velocity_n; // meters per second
-    float velocity_e; // meters per second
-    float velocity_d; // meters per second
-    float velocity_2d; // meters per second
-    float velocity_3d; // meters per second
-
-    float sog_mph; // miles per hour
-    float heading; // degrees 
-    QString cardinal_direction; 
-
-    uint32_t gps_tow_ms;
-    std::chrono::utc_time<std::chrono::milliseconds> utc_time;
-    std::array<uint16_t, 6> utc_datetime;
-
-    uint8_t num_sv;
-    uint8_t correction_age; 
-    std::string differential_mode; 
-
-
-};
+class RideLogger;
+class GnssShmPublisher;
+class EpochMerger;
 
 class GnssClient final : public QObject
 {
@@ -40,27 +22,66 @@ class GnssClient final : public QObject
 public:
     explicit GnssClient(QObject* parent = nullptr);
 
+    // connects and keeps reconnecting until disconnect()
     void connectTcp(const QString& host, quint16 port);
     void disconnect();
 
     bool isConnected() const;
     QString lastErrorString() const;
 
-    // UI polls at 5 Hz
+    // epochs, and raw frames if the logger wants them, are queued to the
+    // logger as they are parsed. The logger must outlive this client.
+    void setRideLogger(RideLogger* logger) { ride_logger_ = logger; }
+
+    // same for local processes reading the shared memory rings
+    void setShmPublisher(GnssShmPublisher* publisher) { shm_publisher_ = publisher; }
+
+    // epochs go to the merger as receiver `receiver`; the merger must
+    // outlive this client and live on the same thread
+    void setEpochMerger(EpochMerger* merger, size_t receiver);
+
+    // applied to the receiver every time the link comes up
+    void setReceiverProfile(const ubx::cfg::ReceiverProfile& profile) { profile_ = profile; }
+    const UbxConfigurator* configurator() const { return configurator_; }
+
+    // sent once, on the first connect, ahead of the profile
+    void setAiding(const ubx::mga::Aiding& aiding);
+    const LinkSupervisor* supervisor() const { return supervisor_; }
+
+    // writes a complete frame to the receiver; false if the link is down
+    bool sendFrame(const std::vector<uint8_t>& frame);
+    bool sendBytes(const uint8_t* data, size_t length);
+
+    // latest epoch; owning thread only, other threads read the merger's copy
     const GnssPvt& state() const { return state_; }
 
 private slots:
+    void onConnected();
+    void onDisconnected();
     void onReadyRead();
     void onSocketError(QAbstractSocket::SocketError);
 
 private:
     QTcpSocket socket_;
     QString last_error_;
+    QString host_;
+    quint16 port_ = 0;
 
     UbloxParser ublox_parser_;
     GnssPvt state_;
 
-    void updateGnssPvt();
-    QString degreesToCardinal(const float degrees);
-    std::array<float, 3> geodetic2Ned(float lat1, float lon1, float h1, float lat2, float lon2, float h2);
+    RideLogger* ride_logger_ = nullptr;
+    GnssShmPublisher* shm_publisher_ = nullptr;
+    EpochMerger* merger_ = nullptr;
+    size_t merger_receiver_ = 0U;
+    UbxConfigurator* configurator_ = nullptr;
+    LinkSupervisor* supervisor_ = nullptr;
+    ubx::cfg::ReceiverProfile profile_;
+    ubx::mga::Aiding aiding_;
+    bool aiding_pending_ = false;
+    int64_t rx_time_ns_ = 0;
+
+    void openLink();
+    void onFrame(MsgClassId id, const uint8_t* frame, size_t length);
+    static int64_t steadyNowNs();
 };
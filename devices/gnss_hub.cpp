@@ -0,0 +1,188 @@
+#include "gnss_hub.h"
+
+#include <chrono>
+
+#include <QTimer>
+
+#include "gnss_client.h"
+
+bool GnssHub::Snapshot::anyConnected() const
+{
+    for (const EpochMerger::SourceHealth& source : merged.sources)
+    {
+        if (source.connected)
+            return true;
+    }
+    return false;
+}
+
+GnssHub::GnssHub(std::vector<Endpoint> endpoints, const ubx::cfg::ReceiverProfile& profile,
+                 QObject* parent)
+    : QObject(parent)
+    , endpoints_(std::move(endpoints))
+    , merger_(EpochMerger::Config{endpoints_.size()})
+{
+    io_thread_.setObjectName("gnss-io");
+
+    snapshot_.receivers.resize(endpoints_.size());
+    for (size_t i = 0; i < endpoints_.size(); ++i)
+        snapshot_.receivers[i].endpoint = QString("%1:%2").arg(endpoints_[i].host).arg(endpoints_[i].port);
+
+    merger_.setUpdateHandler([this](const EpochMerger::Merged& merged) { onMerged(merged); });
+
+    // built here, then handed to the I/O thread before it starts
+    for (size_t i = 0; i < endpoints_.size(); ++i)
+    {
+        auto* client = new GnssClient;
+        client->setReceiverProfile(profile);
+        client->setEpochMerger(&merger_, i);
+        client->moveToThread(&io_thread_);
+        clients_.push_back(client);
+    }
+
+    status_timer_ = new QTimer;
+    status_timer_->setInterval(kStatusIntervalMs);
+    connect(status_timer_, &QTimer::timeout, status_timer_, [this] { refreshStatus(); });
+    status_timer_->moveToThread(&io_thread_);
+}
+
+GnssHub::~GnssHub()
+{
+    io_thread_.quit();
+    io_thread_.wait();
+
+    // the thread is gone, nothing else touches these
+    delete status_timer_;
+    delete rtcm_relay_;
+    for (GnssClient* client : clients_)
+        delete client;
+}
+
+void GnssHub::start()
+{
+    io_thread_.start();
+
+    for (size_t i = 0; i < clients_.size(); ++i)
+    {
+        GnssClient* client = clients_[i];
+        const Endpoint endpoint = endpoints_[i];
+        QMetaObject::invokeMethod(client, [client, endpoint] {
+            client->connectTcp(endpoint.host, endpoint.port);
+        }, Qt::QueuedConnection);
+    }
+
+    if (rtcm_relay_)
+        QMetaObject::invokeMethod(rtcm_relay_, &RtcmRelay::start, Qt::QueuedConnection);
+
+    QMetaObject::invokeMethod(status_timer_, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+}
+
+void GnssHub::setAiding(const ubx::mga::Aiding& aiding)
+{
+    // the I/O thread is not running yet
+    for (GnssClient* client : clients_)
+        client->setAiding(aiding);
+}
+
+void GnssHub::setCorrectionSource(const RtcmRelay::Config& config, size_t receiver)
+{
+    if (rtcm_relay_ || config.host.isEmpty() || receiver >= clients_.size())
+        return;
+
+    // same thread as the client, so a frame is written straight through
+    GnssClient* client = clients_[receiver];
+    rtcm_relay_ = new RtcmRelay(
+        config, [client](const uint8_t* frame, size_t length) { return client->sendBytes(frame, length); });
+    rtcm_relay_->moveToThread(&io_thread_);
+}
+
+void GnssHub::setRideLogger(RideLogger* logger)
+{
+    if (clients_.empty())
+        return;
+
+    GnssClient* client = clients_.front();
+    QMetaObject::invokeMethod(client, [client, logger] { client->setRideLogger(logger); },
+                              Qt::QueuedConnection);
+}
+
+void GnssHub::setShmPublisher(GnssShmPublisher* publisher)
+{
+    if (clients_.empty())
+        return;
+
+    GnssClient* client = clients_.front();
+    QMetaObject::invokeMethod(client, [client, publisher] { client->setShmPublisher(publisher); },
+                              Qt::QueuedConnection);
+}
+
+GnssHub::Snapshot GnssHub::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+void GnssHub::history(int64_t from_ms, int64_t to_ms, size_t max_points, HistoryPyramid::Window& out) const
+{
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    history_.query(from_ms, to_ms, max_points, out);
+}
+
+void GnssHub::onMerged(const EpochMerger::Merged& merged)
+{
+    // the merger publishes per receiver epoch; query once per itow
+    if (merged.valid && merged.itow != query_itow_)
+    {
+        query_itow_ = merged.itow;
+        const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count();
+        if (poi_alerter_)
+            poi_alerter_->update(merged.pvt, now_ms);
+        if (road_matcher_)
+            road_matcher_->update(merged.pvt);
+        if (performance_meter_)
+            performance_meter_->update(merged.nav_pvt);
+        if (rtcm_relay_)
+            rtcm_relay_->setReceiverTime(merged.itow, now_ms * 1000000);
+
+        static constexpr float kFeetPerMeter = 3.28084f;
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        history_.add(now_ms, {merged.pvt.sog_mph, merged.pvt.height_msl * kFeetPerMeter,
+                              static_cast<float>(merged.pvt.num_sv)});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.merged = merged;
+    if (poi_alerter_)
+        snapshot_.poi_alert = poi_alerter_->alert();
+    if (road_matcher_)
+        snapshot_.road = road_matcher_->match();
+    if (performance_meter_)
+        snapshot_.perf = performance_meter_->status();
+}
+
+void GnssHub::refreshStatus()
+{
+    // also the only thing that notices a receiver that stopped talking
+    // without dropping the link
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+    merger_.poll(now_ns);
+
+    std::vector<ReceiverStatus> receivers(clients_.size());
+    for (size_t i = 0; i < clients_.size(); ++i)
+    {
+        receivers[i].endpoint = snapshot_.receivers[i].endpoint;
+        receivers[i].config_status = clients_[i]->configurator()->statusString();
+        receivers[i].link_status = clients_[i]->supervisor()->statusString();
+        receivers[i].last_error = clients_[i]->lastErrorString();
+    }
+
+    const QString rtcm_status = rtcm_relay_ ? rtcm_relay_->statusString() : QString();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.receivers = std::move(receivers);
+    snapshot_.rtcm_status = rtcm_status;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+#include "core/epoch_merger.h"
+#include "core/history_pyramid.h"
+#include "core/performance_meter.h"
+#include "poi/poi_alerter.h"
+#include "road/road_matcher.h"
+#include "rtcm_relay.h"
+#include "ubx_aiding.h"
+#include "ubx_config.h"
+
+class GnssClient;
+class GnssShmPublisher;
+class QTimer;
+class RideLogger;
+
+// Runs every receiver connection on one I/O thread. Each GnssClient keeps
+// its own socket and parser; their epochs meet in an EpochMerger on the
+// same thread, and the merged state is copied out under a lock. The UI
+// thread only ever takes one snapshot per tick, however many receivers
+// there are.
+class GnssHub final : public QObject
+{
+    Q_OBJECT
+public:
+    struct Endpoint {
+        QString host;
+        quint16 port;
+    };
+
+    struct ReceiverStatus {
+        QString endpoint;
+        QString config_status;
+        QString link_status;
+        QString last_error;
+    };
+
+    struct Snapshot {
+        EpochMerger::Merged merged;
+        std::vector<ReceiverStatus> receivers;
+        poi::Alert poi_alert;
+        road::Match road;
+        PerformanceMeter::Status perf;
+        QString rtcm_status; // empty without a correction source
+
+        // from the merger, so it changes as soon as a link does
+        bool anyConnected() const;
+    };
+
+    GnssHub(std::vector<Endpoint> endpoints, const ubx::cfg::ReceiverProfile& profile,
+            QObject* parent = nullptr);
+    ~GnssHub() override;
+
+    // starts the I/O thread and connects every receiver
+    void start();
+
+    // the first receiver feeds the ride log and the shared memory rings; the
+    // targets must outlive the hub
+    void setRideLogger(RideLogger* logger);
+    void setShmPublisher(GnssShmPublisher* publisher);
+
+    // before start(); queried on the I/O thread once per merged epoch
+    void setPoiAlerter(std::unique_ptr<PoiAlerter> alerter) { poi_alerter_ = std::move(alerter); }
+    void setRoadMatcher(std::unique_ptr<RoadMatcher> matcher) { road_matcher_ = std::move(matcher); }
+    void setPerformanceMeter(std::unique_ptr<PerformanceMeter> meter) { performance_meter_ = std::move(meter); }
+
+    // before start(); every receiver gets it on its first connect
+    void setAiding(const ubx::mga::Aiding& aiding);
+
+    // before start(); corrections go to receiver `receiver`
+    void setCorrectionSource(const RtcmRelay::Config& config, size_t receiver = 0U);
+
+    size_t receiverCount() const { return endpoints_.size(); }
+
+    // any thread
+    Snapshot snapshot() const;
+
+    // speed (mph), altitude (ft) and satellites of every merged epoch,
+    // timed by steady_clock milliseconds; any thread
+    void history(int64_t from_ms, int64_t to_ms, size_t max_points, HistoryPyramid::Window& out) const;
+
+private:
+    static constexpr int kStatusIntervalMs = 500;
+
+    std::vector<Endpoint> endpoints_;
+    QThread io_thread_;
+    std::vector<GnssClient*> clients_; // live on io_thread_
+    QTimer* status_timer_ = nullptr;   // live on io_thread_
+    RtcmRelay* rtcm_relay_ = nullptr;  // lives on io_thread_
+    EpochMerger merger_;               // used on io_thread_ only
+    std::unique_ptr<PoiAlerter> poi_alerter_;
+    std::unique_ptr<RoadMatcher> road_matcher_;
+    std::unique_ptr<PerformanceMeter> performance_meter_;
+    uint32_t query_itow_ = UINT32_MAX;
+
+    mutable std::mutex mutex_;
+    Snapshot snapshot_;
+
+    // separate, so a chart query never holds up the snapshot
+    mutable std::mutex history_mutex_;
+    HistoryPyramid history_;
+
+    void onMerged(const EpochMerger::Merged& merged);
+    void refreshStatus();
+};
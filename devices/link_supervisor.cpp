@@ -0,0 +1,264 @@
+#include "link_supervisor.h"
+
+#include <algorithm>
+#include <iostream>
+
+LinkSupervisor::LinkSupervisor(OpenFunction open, AbortFunction abort, QObject* parent)
+    : LinkSupervisor(std::move(open), std::move(abort), Config{}, parent)
+{
+}
+
+LinkSupervisor::LinkSupervisor(OpenFunction open, AbortFunction abort, Config config, QObject* parent)
+    : QObject(parent)
+    , open_(std::move(open))
+    , abort_(std::move(abort))
+    , config_(config)
+    , retry_timer_(this) // parented so they follow moveToThread
+    , connect_timer_(this)
+    , watchdog_(this)
+    , rng_(std::random_device{}())
+{
+    retry_timer_.setSingleShot(true);
+    connect_timer_.setSingleShot(true);
+    // a stall is declared somewhere between stall_timeout and 1.25x of it
+    watchdog_.setInterval(std::max(config_.stall_timeout / 4, std::chrono::milliseconds{50}));
+
+    connect(&retry_timer_, &QTimer::timeout, this, &LinkSupervisor::onRetryTimer);
+    connect(&connect_timer_, &QTimer::timeout, this, &LinkSupervisor::onConnectTimeout);
+    connect(&watchdog_, &QTimer::timeout, this, &LinkSupervisor::onWatchdog);
+}
+
+void LinkSupervisor::start(const QString& name)
+{
+    stop();
+    name_ = name;
+    attempt();
+}
+
+void LinkSupervisor::stop()
+{
+    // set first: the owner's abort must not read as a drop
+    state_ = State::kStopped;
+    retry_timer_.stop();
+    connect_timer_.stop();
+    watchdog_.stop();
+    failures_ = 0U;
+    gap_open_ = false;
+}
+
+void LinkSupervisor::linkUp(int64_t now_ns)
+{
+    if (state_ != State::kConnecting)
+        return;
+
+    connect_timer_.stop();
+    state_ = State::kUp;
+    last_rx_ns_ = now_ns;
+    watchdog_.start();
+    if (gap_open_)
+        gap_.link_ns = now_ns;
+}
+
+void LinkSupervisor::linkDown(Cause cause, const QString& error, int64_t now_ns)
+{
+    // a socket reports one loss through several signals; the first wins
+    if (state_ == State::kUp)
+    {
+        watchdog_.stop();
+        if (!gap_open_)
+        {
+            gap_open_ = true;
+            gap_ = Gap{cause, error, now_ns, 0, 0, 0U};
+        }
+    }
+    else if (state_ == State::kConnecting)
+    {
+        connect_timer_.stop();
+    }
+    else
+    {
+        return;
+    }
+
+    last_cause_ = cause;
+    scheduleRetry(now_ns);
+}
+
+void LinkSupervisor::epoch(bool fix_ok, int64_t now_ns)
+{
+    if (!fix_ok || state_ != State::kUp)
+        return;
+
+    // only a fix proves the link works; a bridge that accepts and then
+    // drops every connection keeps backing off
+    failures_ = 0U;
+    if (gap_open_)
+        closeGap(now_ns);
+}
+
+void LinkSupervisor::attempt()
+{
+    // clear out whatever the socket holds before listening to it again
+    abort_();
+    state_ = State::kConnecting;
+    if (gap_open_)
+        ++gap_.attempts;
+    connect_timer_.start(config_.connect_timeout);
+    open_();
+}
+
+void LinkSupervisor::scheduleRetry(int64_t now_ns)
+{
+    state_ = State::kWaiting;
+    const std::chrono::milliseconds delay = nextDelay();
+    ++failures_;
+    retry_at_ns_ = now_ns + std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    retry_timer_.start(delay);
+}
+
+std::chrono::milliseconds LinkSupervisor::nextDelay()
+{
+    std::chrono::milliseconds nominal = config_.first_retry;
+    if (failures_ > 0U)
+    {
+        // base * 2^(failures - 1), without overflowing on a long outage
+        nominal = config_.base_retry;
+        for (uint32_t i = 1U; i < failures_ && nominal < config_.max_retry; ++i)
+            nominal *= 2;
+        nominal = std::min(nominal, config_.max_retry);
+    }
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double scale = 1.0 - std::clamp(config_.jitter, 0.0, 1.0) * unit(rng_);
+    return std::chrono::milliseconds(static_cast<int64_t>(nominal.count() * scale));
+}
+
+void LinkSupervisor::closeGap(int64_t now_ns)
+{
+    gap_open_ = false;
+    gap_.fix_ns = now_ns;
+
+    gaps_.push_back(gap_);
+    if (gaps_.size() > kMaxGaps)
+        gaps_.pop_front();
+
+    ++stats_.gaps;
+    stats_.total_gap_s += gap_.durationSeconds();
+    stats_.worst_gap_s = std::max(stats_.worst_gap_s, gap_.durationSeconds());
+    stats_.worst_time_to_fix_s = std::max(stats_.worst_time_to_fix_s, gap_.timeToFixSeconds());
+
+    std::cout << "gnss " << name_.toStdString() << ": gap " << gap_.durationSeconds() << " s ("
+              << causeName(gap_.cause);
+    if (!gap_.error.isEmpty())
+        std::cout << ": " << gap_.error.toStdString();
+    std::cout << "), reconnected after " << gap_.reconnectSeconds() << " s in " << gap_.attempts
+              << (gap_.attempts == 1U ? " attempt" : " attempts") << ", fix " << gap_.timeToFixSeconds()
+              << " s later" << std::endl;
+}
+
+void LinkSupervisor::onRetryTimer()
+{
+    if (state_ == State::kWaiting)
+        attempt();
+}
+
+void LinkSupervisor::onConnectTimeout()
+{
+    if (state_ != State::kConnecting)
+        return;
+
+    // leave kConnecting before the abort so its signals are ignored
+    last_cause_ = Cause::kConnectTimeout;
+    scheduleRetry(steadyNowNs());
+    abort_();
+}
+
+void LinkSupervisor::onWatchdog()
+{
+    const int64_t now_ns = steadyNowNs();
+    const int64_t stall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.stall_timeout).count();
+    if (state_ != State::kUp || now_ns - last_rx_ns_ < stall_ns)
+        return;
+
+    // the receiver or the bridge hung without closing the connection
+    linkDown(Cause::kStalled, QString("no data for %1 s").arg((now_ns - last_rx_ns_) * 1e-9, 0, 'f', 1),
+             now_ns);
+    abort_();
+}
+
+QString LinkSupervisor::statusString() const
+{
+    QString text;
+    switch (state_) {
+    case State::kStopped:
+        text = "LINK off";
+        break;
+    case State::kConnecting:
+        text = failures_ == 0U ? QString("LINK connecting") : QString("LINK connecting (try %1)").arg(failures_ + 1U);
+        break;
+    case State::kUp:
+        text = "LINK up";
+        break;
+    case State::kWaiting:
+        text = QString("LINK %1, retry in %2 s")
+                   .arg(causeName(last_cause_))
+                   .arg(std::max<int64_t>(retry_at_ns_ - steadyNowNs(), 0) * 1e-9, 0, 'f', 1);
+        break;
+    }
+
+    if (gap_open_)
+        text += QString("  gap %1 s").arg((steadyNowNs() - gap_.start_ns) * 1e-9, 0, 'f', 1);
+    if (!gaps_.empty())
+        text += QString("  gaps %1, last %2 s (fix +%3 s)")
+                    .arg(stats_.gaps)
+                    .arg(gaps_.back().durationSeconds(), 0, 'f', 1)
+                    .arg(gaps_.back().timeToFixSeconds(), 0, 'f', 2);
+    return text;
+}
+
+LinkSupervisor::Cause LinkSupervisor::causeOf(QAbstractSocket::SocketError error)
+{
+    switch (error) {
+    case QAbstractSocket::ConnectionRefusedError:
+        return Cause::kRefused;
+    case QAbstractSocket::RemoteHostClosedError:
+        return Cause::kRemoteClosed;
+    case QAbstractSocket::HostNotFoundError:
+        return Cause::kHostNotFound;
+    case QAbstractSocket::NetworkError:
+    case QAbstractSocket::TemporaryError:
+        return Cause::kNetwork;
+    case QAbstractSocket::SocketTimeoutError:
+        return Cause::kConnectTimeout;
+    default:
+        return Cause::kOther;
+    }
+}
+
+const char* LinkSupervisor::causeName(Cause cause)
+{
+    switch (cause) {
+    case Cause::kRefused:
+        return "refused";
+    case Cause::kRemoteClosed:
+        return "closed";
+    case Cause::kHostNotFound:
+        return "host not found";
+    case Cause::kNetwork:
+        return "network";
+    case Cause::kConnectTimeout:
+        return "connect timeout";
+    case Cause::kStalled:
+        return "stalled";
+    case Cause::kOther:
+        break;
+    }
+    return "error";
+}
+
+int64_t LinkSupervisor::steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+
+#include <QAbstractSocket>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// Keeps one receiver link up. The owner opens and aborts the transport
+// through the two callbacks and reports what the socket does; the
+// supervisor decides when to try again. The first retry after a drop is
+// almost immediate, since most drops are a blip of the Wi-Fi or the
+// serial bridge; after that the delay doubles up to a ceiling, with
+// jitter so several receivers behind one bridge don't retry in step.
+//
+// A gap runs from losing a working link to the first fix after it comes
+// back, which is what the rider actually notices. Every gap is kept with
+// its cause and how long the reconnect and the fix each took.
+class LinkSupervisor final : public QObject
+{
+    Q_OBJECT
+public:
+    using OpenFunction = std::function<void()>;
+    using AbortFunction = std::function<void()>;
+
+    struct Config {
+        std::chrono::milliseconds first_retry{50};
+        std::chrono::milliseconds base_retry{500};  // second retry, doubling from there
+        std::chrono::milliseconds max_retry{10000};
+        double jitter{0.5};                         // delays drawn from [1 - jitter, 1] of nominal
+        std::chrono::milliseconds connect_timeout{3000};
+        std::chrono::milliseconds stall_timeout{2000}; // link up but silent
+    };
+
+    enum class Cause {
+        kRefused,
+        kRemoteClosed,
+        kHostNotFound,
+        kNetwork,
+        kConnectTimeout,
+        kStalled,
+        kOther,
+    };
+
+    struct Gap {
+        Cause cause;
+        QString error;
+        int64_t start_ns{};
+        int64_t link_ns{};   // link back up
+        int64_t fix_ns{};    // first fix after that
+        uint32_t attempts{}; // connects tried, including the one that worked
+
+        double durationSeconds() const { return (fix_ns - start_ns) * 1e-9; }
+        double reconnectSeconds() const { return (link_ns - start_ns) * 1e-9; }
+        double timeToFixSeconds() const { return (fix_ns - link_ns) * 1e-9; }
+    };
+
+    struct Stats {
+        uint32_t gaps{};          // closed
+        double total_gap_s{};
+        double worst_gap_s{};
+        double worst_time_to_fix_s{};
+    };
+
+    static constexpr size_t kMaxGaps{64U};
+
+    LinkSupervisor(OpenFunction open, AbortFunction abort, QObject* parent = nullptr);
+    LinkSupervisor(OpenFunction open, AbortFunction abort, Config config, QObject* parent = nullptr);
+
+    // `name` labels the gaps in the console log
+    void start(const QString& name);
+    void stop();
+
+    // socket events
+    void linkUp(int64_t now_ns);
+    void linkDown(Cause cause, const QString& error, int64_t now_ns);
+    void bytesReceived(int64_t now_ns) { last_rx_ns_ = now_ns; }
+    // every NAV-PVT; a good one closes the open gap
+    void epoch(bool fix_ok, int64_t now_ns);
+
+    bool isUp() const { return state_ == State::kUp; }
+    bool inGap() const { return gap_open_; }
+    const std::deque<Gap>& gaps() const { return gaps_; }
+    const Stats& stats() const { return stats_; }
+    QString statusString() const;
+
+    static Cause causeOf(QAbstractSocket::SocketError error);
+    static const char* causeName(Cause cause);
+
+private slots:
+    void onRetryTimer();
+    void onConnectTimeout();
+    void onWatchdog();
+
+private:
+    enum class State {
+        kStopped,
+        kConnecting,
+        kUp,
+        kWaiting,
+    };
+
+    OpenFunction open_;
+    AbortFunction abort_;
+    Config config_;
+    QString name_;
+
+    QTimer retry_timer_;
+    QTimer connect_timer_;
+    QTimer watchdog_;
+    std::minstd_rand rng_;
+
+    State state_ = State::kStopped;
+    uint32_t failures_ = 0U; // since the last fix
+    Cause last_cause_ = Cause::kOther;
+    int64_t last_rx_ns_ = 0;
+    int64_t retry_at_ns_ = 0;
+
+    bool gap_open_ = false;
+    Gap gap_{};
+    std::deque<Gap> gaps_;
+    Stats stats_;
+
+    void attempt();
+    void scheduleRetry(int64_t now_ns);
+    std::chrono::milliseconds nextDelay();
+    void closeGap(int64_t now_ns);
+    static int64_t steadyNowNs();
+};
@@ -0,0 +1,163 @@
+#include "rtcm3_framer.h"
+
+#include <algorithm>
+
+#include <boost/crc.hpp>
+
+namespace rtcm3 {
+
+namespace {
+
+constexpr uint32_t kMillisecondsInWeek{604800000U};
+constexpr uint32_t kBeidouToGpsMs{14000U}; // BDT runs 14 s behind GPS time
+
+// payload length of the frame at data, or a value over kMaxPayload if the
+// reserved bits say it is not a frame
+size_t payloadLength(const uint8_t* data)
+{
+    if ((data[1] & 0xFCU) != 0U)
+        return kMaxPayload + 1U;
+    return (static_cast<size_t>(data[1] & 0x03U) << 8) | data[2];
+}
+
+uint32_t bits(const uint8_t* data, size_t first, size_t count)
+{
+    uint32_t value = 0U;
+    for (size_t i = first; i < first + count; ++i)
+        value = (value << 1) | ((data[i / 8U] >> (7U - i % 8U)) & 1U);
+    return value;
+}
+
+} // namespace
+
+uint32_t crc24q(const uint8_t* data, size_t length)
+{
+    boost::crc_optimal<24, 0x864CFBU, 0U, 0U, false, false> crc;
+    crc.process_bytes(data, length);
+    return crc.checksum();
+}
+
+uint16_t messageNumber(const uint8_t* frame, size_t length)
+{
+    if (length < kHeaderSize + 2U + kCrcSize)
+        return 0U;
+    return static_cast<uint16_t>(bits(frame + kHeaderSize, 0U, 12U));
+}
+
+bool msmEpochMs(const uint8_t* frame, size_t length, uint32_t& gps_ms)
+{
+    // number(12) station(12) epoch(30)
+    if (length < kHeaderSize + 7U + kCrcSize)
+        return false;
+
+    const uint16_t number = messageNumber(frame, length);
+    if (number < 1071U || number > 1137U || number % 10U == 0U || number % 10U > 7U)
+        return false;
+
+    const uint32_t epoch = bits(frame + kHeaderSize, 24U, 30U);
+    switch (number / 10U) {
+    case 107U: // GPS
+    case 109U: // Galileo
+    case 111U: // QZSS
+        gps_ms = epoch;
+        break;
+    case 112U: // BeiDou
+        gps_ms = (epoch + kBeidouToGpsMs) % kMillisecondsInWeek;
+        break;
+    default: // GLONASS, SBAS, NavIC
+        return false;
+    }
+    return gps_ms < kMillisecondsInWeek;
+}
+
+} // namespace rtcm3
+
+Rtcm3Framer::Rtcm3Framer()
+{
+    pending_.reserve(rtcm3::kMaxFrame);
+    candidate_.reserve(rtcm3::kMaxFrame);
+}
+
+void Rtcm3Framer::reset()
+{
+    pending_.clear();
+}
+
+void Rtcm3Framer::push(const uint8_t* data, size_t size)
+{
+    size_t used = 0U;
+
+    // finish the frame the last push cut off
+    while (!pending_.empty() && used < size) {
+        const size_t take = std::min(missing(), size - used);
+        pending_.insert(pending_.end(), data + used, data + used + take);
+        used += take;
+        if (missing() > 0U)
+            continue; // the header only now tells the length
+
+        // judged as a whole; what follows a bad one may be another start
+        candidate_.swap(pending_);
+        pending_.clear();
+        const size_t rest = scan(candidate_.data(), candidate_.size());
+        pending_.assign(candidate_.begin() + static_cast<std::ptrdiff_t>(rest), candidate_.end());
+    }
+
+    if (used < size) {
+        const size_t rest = used + scan(data + used, size - used);
+        pending_.assign(data + rest, data + size);
+    }
+}
+
+size_t Rtcm3Framer::missing() const
+{
+    if (pending_.size() < rtcm3::kHeaderSize)
+        return rtcm3::kHeaderSize - pending_.size();
+
+    const size_t payload = rtcm3::payloadLength(pending_.data());
+    if (payload > rtcm3::kMaxPayload)
+        return 0U;
+    const size_t frame = rtcm3::kHeaderSize + payload + rtcm3::kCrcSize;
+    return frame > pending_.size() ? frame - pending_.size() : 0U;
+}
+
+size_t Rtcm3Framer::scan(const uint8_t* data, size_t size)
+{
+    size_t i = 0U;
+    while (i < size) {
+        if (data[i] != rtcm3::kPreamble) {
+            ++stats_.skipped_bytes;
+            ++i;
+            continue;
+        }
+        if (size - i < rtcm3::kHeaderSize)
+            return i;
+
+        const size_t payload = rtcm3::payloadLength(data + i);
+        if (payload > rtcm3::kMaxPayload) {
+            ++stats_.skipped_bytes;
+            ++i;
+            continue;
+        }
+
+        const size_t length = rtcm3::kHeaderSize + payload + rtcm3::kCrcSize;
+        if (size - i < length)
+            return i;
+
+        const uint8_t* crc = data + i + length - rtcm3::kCrcSize;
+        const uint32_t expected = (static_cast<uint32_t>(crc[0]) << 16) | (static_cast<uint32_t>(crc[1]) << 8) | crc[2];
+        if (rtcm3::crc24q(data + i, length - rtcm3::kCrcSize) != expected) {
+            // a 0xD3 inside some other frame, or a damaged one; resync
+            ++stats_.crc_errors;
+            ++stats_.skipped_bytes;
+            ++i;
+            continue;
+        }
+
+        ++stats_.frames;
+        stats_.bytes += length;
+        if (handler_)
+            handler_(data + i, length);
+        i += length;
+    }
+    return size;
+}
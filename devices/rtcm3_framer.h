@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// RTCM 3 transport layer: preamble 0xD3, 6 reserved bits, a 10 bit length,
+// up to 1023 payload bytes and a CRC-24Q over everything before it.
+namespace rtcm3 {
+
+static constexpr uint8_t kPreamble{0xD3U};
+static constexpr size_t kHeaderSize{3U};
+static constexpr size_t kCrcSize{3U};
+static constexpr size_t kMaxPayload{1023U};
+static constexpr size_t kMaxFrame{kHeaderSize + kMaxPayload + kCrcSize};
+
+uint32_t crc24q(const uint8_t* data, size_t length);
+
+// message number, the first 12 bits of the payload; 0 if there are none
+uint16_t messageNumber(const uint8_t* frame, size_t length);
+
+// GNSS epoch of an MSM (1071..1137) as milliseconds of the GPS week, with
+// BeiDou moved onto GPS time. False for other messages and for GLONASS,
+// whose epoch is in Moscow time of day.
+bool msmEpochMs(const uint8_t* frame, size_t length, uint32_t& gps_ms);
+
+} // namespace rtcm3
+
+// Splits a byte stream into CRC-checked RTCM 3 frames. Frames that lie
+// entirely within the bytes of one push() are handed out in place; only a
+// frame cut off by the end of a push is copied, until the next one
+// completes it.
+class Rtcm3Framer {
+    public:
+    // the complete frame, preamble through CRC
+    using FrameHandler = std::function<void(const uint8_t* frame, size_t length)>;
+
+    struct Stats {
+        uint64_t frames{};
+        uint64_t bytes{};         // in valid frames
+        uint64_t crc_errors{};
+        uint64_t skipped_bytes{}; // between frames
+    };
+
+    Rtcm3Framer();
+
+    void setFrameHandler(FrameHandler handler) { handler_ = std::move(handler); }
+    void push(const uint8_t* data, size_t size);
+    // drops a partial frame, e.g. on a new connection
+    void reset();
+
+    const Stats& stats() const { return stats_; }
+
+    private:
+    FrameHandler handler_;
+    Stats stats_;
+    std::vector<uint8_t> pending_;
+    std::vector<uint8_t> candidate_;
+
+    // hands out the frames in data; returns where an incomplete frame
+    // starts, or size
+    size_t scan(const uint8_t* data, size_t size);
+    // bytes pending_ lacks to be a complete frame, 0 once it can be judged
+    size_t missing() const;
+};
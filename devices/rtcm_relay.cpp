@@ -0,0 +1,225 @@
+#include "rtcm_relay.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr int64_t kMillisecondsInWeek{604800000};
+
+LinkSupervisor::Config supervisorConfig()
+{
+    // casters send once a second, some station messages only every ten
+    LinkSupervisor::Config config;
+    config.stall_timeout = std::chrono::milliseconds{5000};
+    return config;
+}
+
+} // namespace
+
+RtcmRelay::RtcmRelay(Config config, ForwardFunction forward, QObject* parent)
+    : QObject(parent)
+    , config_(std::move(config))
+    , forward_(std::move(forward))
+    , socket_(this) // parented so it follows moveToThread
+{
+    supervisor_ = new LinkSupervisor(
+        [this] { openLink(); },
+        [this] {
+            if (socket_.state() != QAbstractSocket::UnconnectedState)
+                socket_.abort();
+        },
+        supervisorConfig(), this);
+
+    connect(&socket_, &QTcpSocket::connected, this, &RtcmRelay::onConnected);
+    connect(&socket_, &QTcpSocket::disconnected, this, &RtcmRelay::onDisconnected);
+    connect(&socket_, &QTcpSocket::readyRead, this, &RtcmRelay::onReadyRead);
+    connect(&socket_, QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred), this,
+            &RtcmRelay::onSocketError);
+
+    framer_.setFrameHandler([this](const uint8_t* frame, size_t length) { onFrame(frame, length); });
+}
+
+void RtcmRelay::start()
+{
+    QString name = QString("rtcm %1:%2").arg(config_.host).arg(config_.port);
+    if (!config_.mountpoint.isEmpty())
+        name += "/" + config_.mountpoint;
+    supervisor_->start(name);
+}
+
+void RtcmRelay::stop()
+{
+    supervisor_->stop();
+    if (socket_.state() != QAbstractSocket::UnconnectedState)
+        socket_.abort();
+    framer_.reset();
+}
+
+void RtcmRelay::setReceiverTime(uint32_t itow_ms, int64_t rx_ns)
+{
+    receiver_itow_ = itow_ms;
+    receiver_rx_ns_ = rx_ns;
+}
+
+void RtcmRelay::openLink()
+{
+    // nothing of the old stream carries over
+    framer_.reset();
+    response_.clear();
+    awaiting_response_ = !config_.mountpoint.isEmpty();
+    socket_.connectToHost(config_.host, config_.port);
+}
+
+QByteArray RtcmRelay::request() const
+{
+    // NTRIP 1.0: the response is the raw stream, not chunked
+    QByteArray text = "GET /" + config_.mountpoint.toUtf8() + " HTTP/1.0\r\n"
+                      "User-Agent: NTRIP motohud/1.0\r\n"
+                      "Accept: */*\r\n";
+    if (!config_.user.isEmpty())
+        text += "Authorization: Basic " + (config_.user + ":" + config_.password).toUtf8().toBase64() + "\r\n";
+    text += "\r\n";
+    return text;
+}
+
+void RtcmRelay::onConnected()
+{
+    supervisor_->linkUp(steadyNowNs());
+    // no Nagle delay on the way back either; the request is one write
+    socket_.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    if (awaiting_response_)
+        socket_.write(request());
+}
+
+void RtcmRelay::onDisconnected()
+{
+    supervisor_->linkDown(LinkSupervisor::Cause::kRemoteClosed, {}, steadyNowNs());
+}
+
+void RtcmRelay::onSocketError(QAbstractSocket::SocketError error)
+{
+    supervisor_->linkDown(LinkSupervisor::causeOf(error), socket_.errorString(), steadyNowNs());
+}
+
+void RtcmRelay::onReadyRead()
+{
+    while (socket_.bytesAvailable() > 0) {
+        const qint64 n = socket_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<qint64>(buffer_.size()));
+        if (n <= 0)
+            return;
+
+        read_ns_ = steadyNowNs();
+        supervisor_->bytesReceived(read_ns_);
+
+        const uint8_t* data = buffer_.data();
+        size_t size = static_cast<size_t>(n);
+        if (awaiting_response_ && !parseResponse(data, size)) {
+            supervisor_->linkDown(LinkSupervisor::Cause::kOther,
+                                  QString("caster refused: %1").arg(QString::fromStdString(response_)), read_ns_);
+            socket_.abort();
+            return;
+        }
+        framer_.push(data, size);
+    }
+}
+
+bool RtcmRelay::parseResponse(const uint8_t*& data, size_t& size)
+{
+    const size_t before = response_.size();
+    response_.append(reinterpret_cast<const char*>(data), size);
+
+    const size_t status_end = response_.find("\r\n");
+    if (status_end == std::string::npos) {
+        // everything so far is the status line
+        size = 0U;
+        return response_.size() <= kMaxResponseHeader;
+    }
+
+    // NTRIP 1.0 casters send the bare status line and go straight into the
+    // stream; only an HTTP response has headers up to a blank line
+    size_t end = std::string::npos;
+    if (response_.compare(0, 4, "ICY ") == 0) {
+        end = status_end + 2U;
+    } else if (response_.compare(0, 7, "HTTP/1.") == 0) {
+        const size_t blank = response_.find("\r\n\r\n");
+        if (blank == std::string::npos) {
+            size = 0U;
+            return response_.size() <= kMaxResponseHeader;
+        }
+        end = blank + 4U;
+    }
+
+    response_.resize(status_end);
+    if (end == std::string::npos || response_.find(" 200") == std::string::npos)
+        return false;
+
+    const size_t consumed = end - before;
+    data += consumed;
+    size -= consumed;
+    awaiting_response_ = false;
+    return true;
+}
+
+void RtcmRelay::onFrame(const uint8_t* frame, size_t length)
+{
+    stats_.last_message = rtcm3::messageNumber(frame, length);
+
+    if (!forward_ || !forward_(frame, length)) {
+        ++stats_.forward_failures;
+        return;
+    }
+
+    const int64_t now_ns = steadyNowNs();
+    ++stats_.forwarded;
+    status_bytes_ += length;
+    stats_.last_latency_us = static_cast<float>((now_ns - read_ns_) * 1e-3);
+    stats_.max_latency_us = std::max(stats_.max_latency_us, stats_.last_latency_us);
+    // a good frame through to the receiver is this link's "fix"
+    supervisor_->epoch(true, now_ns);
+
+    uint32_t epoch_ms = 0U;
+    if (receiver_rx_ns_ != 0 && rtcm3::msmEpochMs(frame, length, epoch_ms)) {
+        // receiver time now, carried forward from its last epoch
+        const int64_t receiver_ms = receiver_itow_ + (now_ns - receiver_rx_ns_) / 1000000;
+        int64_t age_ms = (receiver_ms - epoch_ms) % kMillisecondsInWeek;
+        if (age_ms < -kMillisecondsInWeek / 2)
+            age_ms += kMillisecondsInWeek;
+        else if (age_ms > kMillisecondsInWeek / 2)
+            age_ms -= kMillisecondsInWeek;
+        stats_.correction_age_s = static_cast<float>(std::max<int64_t>(age_ms, 0) * 1e-3);
+    }
+}
+
+QString RtcmRelay::statusString()
+{
+    const int64_t now_ns = steadyNowNs();
+    if (last_status_ns_ != 0 && now_ns > last_status_ns_)
+        stats_.rate_bps = static_cast<float>(status_bytes_ * 1e9 / (now_ns - last_status_ns_));
+    last_status_ns_ = now_ns;
+    status_bytes_ = 0U;
+    stats_.framer = framer_.stats();
+
+    QString text = QString("RTCM %1  %2 B/s  frames %3  crc %4")
+                       .arg(supervisor_->statusString())
+                       .arg(stats_.rate_bps, 0, 'f', 0)
+                       .arg(stats_.forwarded)
+                       .arg(stats_.framer.crc_errors);
+    if (stats_.forwarded > 0U)
+        text += QString("  last %1  latency %2 us (max %3)")
+                    .arg(stats_.last_message)
+                    .arg(stats_.last_latency_us, 0, 'f', 0)
+                    .arg(stats_.max_latency_us, 0, 'f', 0);
+    if (stats_.correction_age_s >= 0.0f)
+        text += QString("  age %1 s").arg(stats_.correction_age_s, 0, 'f', 1);
+    if (stats_.forward_failures > 0U)
+        text += QString("  dropped %1").arg(stats_.forward_failures);
+    return text;
+}
+
+int64_t RtcmRelay::steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
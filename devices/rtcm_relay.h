@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <QObject>
+#include <QString>
+#include <QTcpSocket>
+
+#include "link_supervisor.h"
+#include "rtcm3_framer.h"
+
+// Pulls RTCM 3 corrections from a caster and writes them into a receiver
+// link. With a mountpoint it speaks NTRIP 1.0 (a GET, then the raw stream
+// after "ICY 200 OK"); without one the caster is a plain TCP stream, e.g.
+// a base station's own port or the simulator's stand-in.
+//
+// Lives on the receivers' I/O thread, so a frame is written to the receiver
+// socket straight from this one's read buffer, in the same event and
+// without a queue or a copy of its own. Frames failing their CRC-24Q never
+// reach the receiver.
+class RtcmRelay final : public QObject
+{
+    Q_OBJECT
+public:
+    // writes one frame to the receiver; false if it could not
+    using ForwardFunction = std::function<bool(const uint8_t* frame, size_t length)>;
+
+    struct Config {
+        QString host; // empty: no corrections
+        quint16 port{2101};
+        QString mountpoint; // empty: raw stream, no NTRIP request
+        QString user;       // basic auth, with password
+        QString password;
+    };
+
+    struct Stats {
+        Rtcm3Framer::Stats framer;
+        uint64_t forwarded{};
+        uint64_t forward_failures{}; // receiver link down
+        uint16_t last_message{};
+        // read from the caster socket to written to the receiver socket
+        float last_latency_us{};
+        float max_latency_us{};
+        // newest MSM epoch against the receiver's time; negative if unknown
+        float correction_age_s{-1.0f};
+        float rate_bps{}; // forwarded, over the last status interval
+    };
+
+    RtcmRelay(Config config, ForwardFunction forward, QObject* parent = nullptr);
+
+    void start();
+    void stop();
+
+    // GPS time of the receiver's latest epoch and when it arrived, to age
+    // the corrections against; same thread
+    void setReceiverTime(uint32_t itow_ms, int64_t rx_ns);
+
+    const Config& config() const { return config_; }
+    // framer counts as of the last statusString()
+    const Stats& stats() const { return stats_; }
+    const LinkSupervisor* supervisor() const { return supervisor_; }
+    // one line for the status page; also rolls the rate window
+    QString statusString();
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void onSocketError(QAbstractSocket::SocketError);
+
+private:
+    static constexpr size_t kReadSize{4096U};
+    static constexpr size_t kMaxResponseHeader{4096U};
+
+    Config config_;
+    ForwardFunction forward_;
+    QTcpSocket socket_;
+    LinkSupervisor* supervisor_ = nullptr;
+    Rtcm3Framer framer_;
+    std::array<uint8_t, kReadSize> buffer_{};
+
+    bool awaiting_response_ = false; // NTRIP response header still coming
+    std::string response_;
+    int64_t read_ns_ = 0;
+
+    uint32_t receiver_itow_ = 0U;
+    int64_t receiver_rx_ns_ = 0;
+    int64_t last_status_ns_ = 0;
+    uint64_t status_bytes_ = 0U;
+    Stats stats_;
+
+    void openLink();
+    void onFrame(const uint8_t* frame, size_t length);
+    // false when the caster refused; consumes the header from data
+    bool parseResponse(const uint8_t*& data, size_t& size);
+    QByteArray request() const;
+    static int64_t steadyNowNs();
+};
@@ -1,15 +1,19 @@
 #include "ublox_parser.h"
 
-#include <ios>
-#include <iostream>
+#include <cstring>
+#include <span>
 
 
 
 UbloxParser::UbloxParser() {}
 
-void UbloxParser::read_bytes(const QByteArray bytes) {
+void UbloxParser::setFrameHandler(FrameHandler handler) {
+  frame_handler_ = std::move(handler);
+}
+
+void UbloxParser::read_bytes(const uint8_t* data, size_t length) {
 
-  for (const uint8_t b : bytes) {
+  for (const uint8_t b : std::span<const uint8_t>(data, length)) {
     switch (state_) {
     case State::kUnknown:
     // intentional fall-through
@@ -24,10 +28,18 @@ void UbloxParser::read_bytes(const QByteArray bytes) {
     } break;
 
     case State::kSyn1: {
-      state_ = b == kSynByte2 ? State::kSyn2 : State::kUnknown;
+      // a repeated first sync byte may be the real one
+      if (b == kSynByte2) {
+        state_ = State::kSyn2;
+      } else if (b != kSynByte1) {
+        state_ = State::kUnknown;
+      }
     } break;
 
     case State::kSyn2: {
+      frame_[0] = kSynByte1;
+      frame_[1] = kSynByte2;
+      frame_[2] = b;
       msg_id_ = static_cast<uint16_t>(b) << 8;
       state_ = State::kMsgClass;
       checksum_a_ = b;
@@ -35,6 +47,7 @@ void UbloxParser::read_bytes(const QByteArray bytes) {
     } break;
 
     case State::kMsgClass: {
+      frame_[3] = b;
       msg_id_ |= static_cast<uint16_t>(b);
       state_ = State::kMsgId;
       checksum_a_ += b;
@@ -43,6 +56,7 @@ void UbloxParser::read_bytes(const QByteArray bytes) {
     } break;
 
     case State::kMsgId: {
+      frame_[4] = b;
       payload_length_ = b;
       state_ = State::kPayloadLength;
       checksum_a_ += b;
@@ -50,115 +64,166 @@ void UbloxParser::read_bytes(const QByteArray bytes) {
     } break;
 
     case State::kPayloadLength: {
+      frame_[5] = b;
       payload_length_ |= static_cast<size_t>(b) << 8;
+      checksum_a_ += b;
+      checksum_b_ += checksum_a_;
 
-      if (payload_length_ > payload_.size()) {
-        std::cout << "ubx packet exceeds max size, id:" <<msg_id_ << " len: " << payload_length_
-                  << " size: " << payload_.size() << "\n";
+      if (payload_length_ > kMaxPacketSize) {
+        ++stats_.oversize;
         state_ = State::kUnknown;
       } else {
         payload_received_ = 0U;
-        state_ = State::kPayload;
+        state_ = payload_length_ == 0U ? State::kChecksumA : State::kPayload;
       }
-      checksum_a_ += b;
-        checksum_b_ += checksum_a_;
     } break;
 
     case State::kPayload: {
-      if (payload_received_ < payload_length_) {
-        payload_[payload_received_++] = b;
-        checksum_a_ += b;
-        checksum_b_ += checksum_a_;
-      } else if (checksum_a_ == b) {
+      frame_[kHeaderSize + payload_received_++] = b;
+      checksum_a_ += b;
+      checksum_b_ += checksum_a_;
+      if (payload_received_ == payload_length_) {
         state_ = State::kChecksumA;
+      }
+    } break;
+
+    case State::kChecksumA: {
+      if (b == checksum_a_) {
+        frame_[kHeaderSize + payload_length_] = b;
+        state_ = State::kChecksumB;
       } else {
-        std::cout << "failed to decode msg.\n";
+        ++stats_.checksum_errors;
         state_ = State::kUnknown;
       }
     } break;
 
-    case State::kChecksumA:
-      if (checksum_b_ == b) {
-        const bool success = processMessage(static_cast<MsgClassId>(msg_id_), payload_);
-        // payload_.clear(); 
-        if (!success) {
-          state_ = State::kUnknown;
-          std::cout << "ubx packet failed parsing.\n";
-        } else {
-
-          state_ = State::kIdle;
-        }
+    case State::kChecksumB: {
+      if (b != checksum_b_) {
+        ++stats_.checksum_errors;
+        state_ = State::kUnknown;
+        break;
       }
 
-    default:
-      state_ = State::kUnknown;
+      ++stats_.frames;
+      frame_[kHeaderSize + payload_length_ + 1] = b;
+      const bool success = processMessage(static_cast<MsgClassId>(msg_id_), payload());
+      if (frame_handler_) {
+        frame_handler_(static_cast<MsgClassId>(msg_id_), frame_.data(),
+                       payload_length_ + kFrameOverhead);
+      }
+      if (!success) {
+        ++stats_.rejected;
+      }
+      state_ = State::kIdle;
+    } break;
     }
   }
 
 }
 
-bool UbloxParser::processMessage(
-    MsgClassId id, const std::array< uint8_t, kMaxPacketSize>& payload) {
+bool UbloxParser::processMessage(MsgClassId id, const uint8_t* payload) {
 
-  bool status = true;
+  // messages decoded here must have exactly their size; anything else is
+  // left to the frame handler. The payload sits at an odd offset in frame_,
+  // so it is copied rather than cast.
   switch (id) {
   case MsgClassId::kUbxNavPvt: {
+    if (payload_length_ != sizeof(UbxNavPvtMsg)) {
+        return false;
+    }
+    std::memcpy(&nav_pvt_data_, payload, sizeof(nav_pvt_data_));
+  } break;
 
-    
-    if (payload_length_ == sizeof(UbxNavPvtMsg)) {
-        nav_pvt_data_ = *reinterpret_cast<const UbxNavPvtMsg*>(payload.data());
-        status = true;
+  case MsgClassId::kUbxNavHpposllh: {
+    if (payload_length_ != sizeof(UbxNavHpposllhMsg)) {
+        return false;
     }
-  }break;
+    std::memcpy(&nav_hpposllh_data_, payload, sizeof(nav_hpposllh_data_));
+    have_hpposllh_ = true;
+  } break;
+
+  case MsgClassId::kUbxNavRelposned: {
+    if (payload_length_ != sizeof(UbxNavRelposnedMsg)) {
+        return false;
+    }
+    std::memcpy(&nav_relposned_data_, payload, sizeof(nav_relposned_data_));
+  } break;
+
+  default:
+    break;
 
   }
 
-  return status;
+  return true;
+}
+
+int32_t UbloxParser::latitude() const {
+    return nav_pvt_data_.lat.value();
 }
 
-float UbloxParser::latitude() {
-    return nav_pvt_data_.lat.value() * kPositionScalingFactor;
+int32_t UbloxParser::longitude() const {
+    return nav_pvt_data_.lon.value();
 }
 
-float UbloxParser::longitude() {
-    return nav_pvt_data_.lon.value() * kPositionScalingFactor;
+GeoPoint UbloxParser::position() const {
+
+    GeoPoint p;
+    const UbxNavHpposllhMsg& hp = nav_hpposllh_data_;
+    if (have_hpposllh_ && !hp.flags.invalid_llh && hp.itow.value() == nav_pvt_data_.itow.value()) {
+        // same epoch: take the whole high precision solution so the
+        // residuals line up with their base values
+        p.lat = hp.lat.value();
+        p.lon = hp.lon.value();
+        p.height = hp.height.value();
+        p.height_msl = hp.height_msl.value();
+        p.lat_hp = hp.lat_hp;
+        p.lon_hp = hp.lon_hp;
+        p.height_hp = hp.height_hp;
+        p.height_msl_hp = hp.height_msl_hp;
+    } else {
+        p.lat = nav_pvt_data_.lat.value();
+        p.lon = nav_pvt_data_.lon.value();
+        p.height = nav_pvt_data_.height.value();
+        p.height_msl = nav_pvt_data_.height_msl.value();
+    }
+    return p;
 }
 
-float UbloxParser::height_msl() {
-    return nav_pvt_data_.height_msl.value() * kPositionScalingFactor;
+float UbloxParser::height_msl() const {
+    return nav_pvt_data_.height_msl.value() * kAltitudeScalingFactor;
 }
 
-float UbloxParser::velocity_n() {
+float UbloxParser::velocity_n() const {
     return nav_pvt_data_.velocity_n.value();
 }
 
-float UbloxParser::velocity_e() {
+float UbloxParser::velocity_e() const {
     return nav_pvt_data_.velocity_e.value();
 }
 
-float UbloxParser::velocity_d() {
+float UbloxParser::velocity_d() const {
     return nav_pvt_data_.velocity_d.value();
 }
 
-float UbloxParser::heading() {
+float UbloxParser::heading() const {
     return nav_pvt_data_.heading_motion.value() * kHeadingScalingFactor;
 }
 
-uint32_t UbloxParser::itow() {
+uint32_t UbloxParser::itow() const {
     return nav_pvt_data_.itow.value();
 }
 
-uint8_t UbloxParser::numSv() {
+uint8_t UbloxParser::numSv() const {
     return nav_pvt_data_.num_sv;
 }
 
-std::array<uint16_t, 6> UbloxParser::utcDateTime() {
+std::array<uint16_t, 6> UbloxParser::utcDateTime() const {
 
     
     return std::array<uint16_t,6>{nav_pvt_data_.year.value(), nav_pvt_data_.month, nav_pvt_data_.day, nav_pvt_data_.hour, nav_pvt_data_.min, nav_pvt_data_.sec};
 }
 
-std::string UbloxParser::differentialMode(){
+std::string UbloxParser::differentialMode() const {
 
     const std::array<std::string, 4> modes = {"SPS", "DGNSS", "FLOAT", "INTEGER"};
 
@@ -186,7 +251,7 @@ std::string UbloxParser::differentialMode(){
     return mode; 
 }
 
-uint8_t UbloxParser::correctionAge() {
+uint8_t UbloxParser::correctionAge() const {
 
     uint8_t age;
 
@@ -252,4 +317,19 @@ uint8_t UbloxParser::correctionAge() {
     return age; 
 }
 
-void UbloxParser::reset() {}
+void UbloxParser::reset() {
+  // drop any half-read frame and every message of the old stream, so a
+  // reconnect can't pair a stale NAV-PVT with fresh HPPOSLLH residuals.
+  // The frame handler and the counters stay.
+  state_ = State::kUnknown;
+  msg_id_ = 0U;
+  checksum_a_ = 0U;
+  checksum_b_ = 0U;
+  payload_length_ = 0U;
+  payload_received_ = 0U;
+
+  nav_pvt_data_ = UbxNavPvtMsg{};
+  nav_hpposllh_data_ = UbxNavHpposllhMsg{};
+  have_hpposllh_ = false;
+  nav_relposned_data_ = UbxNavRelposnedMsg{};
+}
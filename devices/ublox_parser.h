@@ -1,33 +1,66 @@
 #pragma once 
 
 
-#include <QObject>
+#include <cstddef>
+#include <functional>
+#include <string>
 
+#include "core/geo_point.h"
 #include "ubx_types.h"
 
 class UbloxParser {
 
     public:
+    // called with the complete frame (sync bytes through checksum) of every
+    // message that passes its checksum, after the parser has consumed it.
+    using FrameHandler = std::function<void(MsgClassId id, const uint8_t* frame, size_t length)>;
+
     UbloxParser();
-    void read_bytes(const QByteArray bytes); 
-    void reset(); 
-
-    float latitude();
-    float longitude();
-    float height_msl(); 
-    float velocity_n();
-    float velocity_e();
-    float velocity_d();
-    float heading();
-    uint32_t itow(); 
-    uint8_t numSv();
-    std::array<uint16_t, 6> utcDateTime();
-    std::string differentialMode();
-    uint8_t correctionAge();
+    void setFrameHandler(FrameHandler handler);
+    void read_bytes(const uint8_t* data, size_t length);
+    // any contiguous byte container, e.g. QByteArray or std::vector<uint8_t>
+    template <typename Bytes>
+    void read_bytes(const Bytes& bytes) {
+        read_bytes(reinterpret_cast<const uint8_t*>(bytes.data()), static_cast<size_t>(bytes.size()));
+    }
+    // back to hunting for a sync byte, latest messages cleared; for a new
+    // connection to the same receiver
+    void reset();
+
+    int32_t latitude() const; // 1e-7 degrees
+    int32_t longitude() const; // 1e-7 degrees
+    // latest NAV-PVT position, refined by NAV-HPPOSLLH when the receiver
+    // sent a valid one for the same epoch
+    GeoPoint position() const;
+    float height_msl() const; // meters
+    float velocity_n() const;
+    float velocity_e() const;
+    float velocity_d() const;
+    float heading() const;
+    uint32_t itow() const; 
+    uint8_t numSv() const;
+    std::array<uint16_t, 6> utcDateTime() const;
+    std::string differentialMode() const;
+    uint8_t correctionAge() const;
+
+    const UbxNavPvtMsg& navPvt() const { return nav_pvt_data_; }
+    const UbxNavHpposllhMsg& navHpposllh() const { return nav_hpposllh_data_; }
+    const UbxNavRelposnedMsg& navRelposned() const { return nav_relposned_data_; }
+
+    struct Stats {
+        uint64_t frames{};          // passed the checksum
+        uint64_t checksum_errors{};
+        uint64_t oversize{};        // length field above kMaxPacketSize
+        uint64_t rejected{};        // valid frame of a decoded message with the wrong length
+    };
+    const Stats& stats() const { return stats_; }
 
-    private:
     static constexpr uint16_t kMaxPacketSize{640U};
-    static constexpr float kPositionScalingFactor{1e-7};
+    static constexpr size_t kHeaderSize{6U}; // sync, class, id, length
+    static constexpr size_t kFrameOverhead{kHeaderSize + 2U}; // + checksum
+    static constexpr size_t kMaxFrameSize{kMaxPacketSize + kFrameOverhead};
+
+    private:
     static constexpr float kAltitudeScalingFactor{1e-3};
     static constexpr float kHeadingScalingFactor{1e-5};
 
@@ -41,7 +74,7 @@ class UbloxParser {
         kPayloadLength,
         kPayload,
         kChecksumA,
-        
+        kChecksumB,
     };
 
     State state_{};
@@ -49,12 +82,19 @@ class UbloxParser {
     uint8_t checksum_a_{};
     uint8_t checksum_b_{};
     size_t payload_length_{};
-    std::array<uint8_t, kMaxPacketSize> payload_{};
+    std::array<uint8_t, kMaxFrameSize> frame_{};
     uint16_t payload_received_{};
 
     UbxNavPvtMsg nav_pvt_data_{};
+    UbxNavHpposllhMsg nav_hpposllh_data_{};
+    bool have_hpposllh_{};
+    UbxNavRelposnedMsg nav_relposned_data_{};
+    FrameHandler frame_handler_;
+    Stats stats_{};
 
-    bool processMessage(MsgClassId id, const std::array< uint8_t, kMaxPacketSize>& payload);
+    const uint8_t* payload() const { return frame_.data() + kHeaderSize; }
+    // false when a message it decodes does not have that message's length
+    bool processMessage(MsgClassId id, const uint8_t* payload);
 
 
 
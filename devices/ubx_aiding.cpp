@@ -0,0 +1,80 @@
+#include "ubx_aiding.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/timex.h>
+
+#include "ubx_frame.h"
+#include "ubx_types.h"
+
+namespace ubx::mga {
+
+namespace {
+
+template <typename Msg>
+std::vector<uint8_t> toPayload(const Msg& msg)
+{
+    std::vector<uint8_t> payload(sizeof(msg));
+    std::memcpy(payload.data(), &msg, sizeof(msg));
+    return payload;
+}
+
+} // namespace
+
+std::vector<uint8_t> encodeIniPosLlh(int32_t lat, int32_t lon, int32_t height_mm, uint32_t acc_mm)
+{
+    UbxMgaIniPosLlhMsg msg;
+    msg.lat = lat;
+    msg.lon = lon;
+    msg.alt = height_mm / 10;
+    msg.pos_acc = std::max(acc_mm / 10U, 1U);
+    return toPayload(msg);
+}
+
+std::vector<uint8_t> encodeIniTimeUtc(std::chrono::system_clock::time_point time, uint32_t acc_ms)
+{
+    using namespace std::chrono;
+    const sys_days day = floor<days>(time);
+    const year_month_day date{day};
+    const hh_mm_ss<nanoseconds> clock{duration_cast<nanoseconds>(time - day)};
+
+    UbxMgaIniTimeUtcMsg msg;
+    msg.year = static_cast<uint16_t>(static_cast<int>(date.year()));
+    msg.month = static_cast<uint8_t>(static_cast<unsigned>(date.month()));
+    msg.day = static_cast<uint8_t>(static_cast<unsigned>(date.day()));
+    msg.hour = static_cast<uint8_t>(clock.hours().count());
+    msg.minute = static_cast<uint8_t>(clock.minutes().count());
+    msg.second = static_cast<uint8_t>(clock.seconds().count());
+    msg.ns = static_cast<uint32_t>(clock.subseconds().count());
+    msg.t_acc_s = static_cast<uint16_t>(std::min<uint32_t>(acc_ms / 1000U, UINT16_MAX));
+    msg.t_acc_ns = (acc_ms % 1000U) * 1000000U;
+    return toPayload(msg);
+}
+
+bool systemClockSynchronized(uint32_t& max_error_ms)
+{
+    timex tx{};
+    if (::adjtimex(&tx) == TIME_ERROR || (tx.status & STA_UNSYNC) != 0)
+        return false;
+    max_error_ms = static_cast<uint32_t>(std::max<long>(tx.maxerror / 1000, 1));
+    return true;
+}
+
+std::vector<uint8_t> aidingFrames(const Aiding& aiding, std::chrono::system_clock::time_point now)
+{
+    std::vector<uint8_t> frames;
+    if (aiding.have_position) {
+        const std::vector<uint8_t> frame = buildFrame(
+            MsgClassId::kUbxMgaIni, encodeIniPosLlh(aiding.lat, aiding.lon, aiding.height, aiding.position_acc_mm));
+        frames.insert(frames.end(), frame.begin(), frame.end());
+    }
+    if (aiding.have_time) {
+        const std::vector<uint8_t> frame =
+            buildFrame(MsgClassId::kUbxMgaIni, encodeIniTimeUtc(now, aiding.time_acc_ms));
+        frames.insert(frames.end(), frame.begin(), frame.end());
+    }
+    return frames;
+}
+
+} // namespace ubx::mga
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Assistance (MGA-INI) for a receiver starting without a fix. A rough
+// position and time let it search for the satellites that should be up
+// instead of all of them, which shortens the first fix from a cold start.
+namespace ubx::mga {
+
+struct Aiding {
+    bool have_position{};
+    int32_t lat{}; // 1e-7 deg
+    int32_t lon{};
+    int32_t height{}; // mm above ellipsoid
+    uint32_t position_acc_mm{};
+
+    // the system clock at the time of sending, when it can be trusted
+    bool have_time{};
+    uint32_t time_acc_ms{};
+};
+
+std::vector<uint8_t> encodeIniPosLlh(int32_t lat, int32_t lon, int32_t height_mm, uint32_t acc_mm);
+std::vector<uint8_t> encodeIniTimeUtc(std::chrono::system_clock::time_point time, uint32_t acc_ms);
+
+// true when the kernel clock is disciplined (NTP, PPS); its worst case
+// error bound goes to max_error_ms. An unsynchronized clock on a board
+// without a battery backed RTC can be days off and is no aid.
+bool systemClockSynchronized(uint32_t& max_error_ms);
+
+// complete frames, position first; empty when there is nothing to send
+std::vector<uint8_t> aidingFrames(const Aiding& aiding, std::chrono::system_clock::time_point now);
+
+} // namespace ubx::mga
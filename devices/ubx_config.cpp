@@ -0,0 +1,101 @@
+#include "ubx_config.h"
+
+#include <algorithm>
+
+namespace ubx::cfg {
+
+namespace {
+
+void putLe(std::vector<uint8_t>& out, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+uint64_t getLe(const uint8_t* data, size_t size)
+{
+    uint64_t value = 0U;
+    for (size_t i = 0; i < size; ++i)
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+uint32_t nmeaKey(Port port)
+{
+    switch (port) {
+    case Port::kI2c: return key::kI2cOutProtNmea;
+    case Port::kUart1: return key::kUart1OutProtNmea;
+    case Port::kUart2: return key::kUart2OutProtNmea;
+    case Port::kUsb: return key::kUsbOutProtNmea;
+    case Port::kSpi: return key::kSpiOutProtNmea;
+    }
+    return 0U;
+}
+
+} // namespace
+
+size_t valueSize(uint32_t key)
+{
+    switch ((key >> 28) & 0x07U) {
+    case 1: // one bit, stored in a byte
+    case 2: return 1U;
+    case 3: return 2U;
+    case 4: return 4U;
+    case 5: return 8U;
+    default: return 0U;
+    }
+}
+
+std::vector<KeyValue> profileKeyValues(const ReceiverProfile& profile)
+{
+    std::vector<KeyValue> values;
+    values.push_back({key::kRateMeas, std::max(profile.meas_rate_ms, kMinMeasRateMs)});
+    values.push_back({key::kRateNav, 1U});
+
+    for (const Port port : profile.ports) {
+        for (const MessageRate& message : profile.messages)
+            values.push_back({message.keys[static_cast<size_t>(port)], message.rate});
+        if (profile.disable_nmea)
+            values.push_back({nmeaKey(port), 0U});
+    }
+    return values;
+}
+
+std::vector<uint8_t> encodeValset(const std::vector<KeyValue>& values, uint8_t layers)
+{
+    std::vector<uint8_t> payload{0x00U /* version */, layers, 0x00U, 0x00U};
+    for (const KeyValue& kv : values) {
+        putLe(payload, kv.key, 4);
+        putLe(payload, kv.value, valueSize(kv.key));
+    }
+    return payload;
+}
+
+std::vector<uint8_t> encodeValget(const std::vector<KeyValue>& keys, ValgetLayer layer)
+{
+    std::vector<uint8_t> payload{0x00U /* version */, static_cast<uint8_t>(layer), 0x00U, 0x00U};
+    for (const KeyValue& kv : keys)
+        putLe(payload, kv.key, 4);
+    return payload;
+}
+
+bool decodeValget(const uint8_t* payload, size_t length, std::vector<KeyValue>& values)
+{
+    values.clear();
+    if (length < 4U || payload[0] != 0x01U)
+        return false;
+
+    size_t offset = 4U;
+    while (offset + 4U <= length) {
+        const uint32_t key = static_cast<uint32_t>(getLe(payload + offset, 4));
+        const size_t size = valueSize(key);
+        offset += 4U;
+        if (size == 0U || offset + size > length)
+            return false;
+        values.push_back({key, getLe(payload + offset, size)});
+        offset += size;
+    }
+    return offset == length;
+}
+
+} // namespace ubx::cfg
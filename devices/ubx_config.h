@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Configuration interface (CFG-VALSET / CFG-VALGET) of generation 9+ u-blox
+// receivers. Key IDs are from the u-blox F9 interface description; the size
+// of a value is encoded in bits 28..30 of its key.
+namespace ubx::cfg {
+
+namespace key {
+// CFG-RATE
+static constexpr uint32_t kRateMeas{0x30210001U}; // U2, ms between measurements
+static constexpr uint32_t kRateNav{0x30210002U};  // U2, measurements per solution
+
+// CFG-MSGOUT-UBX_NAV_PVT_<port>, U1 output rate per navigation solution
+static constexpr uint32_t kMsgOutNavPvtI2c{0x20910006U};
+static constexpr uint32_t kMsgOutNavPvtUart1{0x20910007U};
+static constexpr uint32_t kMsgOutNavPvtUart2{0x20910008U};
+static constexpr uint32_t kMsgOutNavPvtUsb{0x20910009U};
+static constexpr uint32_t kMsgOutNavPvtSpi{0x2091000AU};
+
+// CFG-MSGOUT-UBX_NAV_HPPOSLLH_<port>, high precision receivers (F9P, F9R)
+static constexpr uint32_t kMsgOutNavHpposllhI2c{0x20910033U};
+static constexpr uint32_t kMsgOutNavHpposllhUart1{0x20910034U};
+static constexpr uint32_t kMsgOutNavHpposllhUart2{0x20910035U};
+static constexpr uint32_t kMsgOutNavHpposllhUsb{0x20910036U};
+static constexpr uint32_t kMsgOutNavHpposllhSpi{0x20910037U};
+
+// CFG-MSGOUT-UBX_NAV_RELPOSNED_<port>, output by the rover of a pair
+static constexpr uint32_t kMsgOutNavRelposnedI2c{0x2091008DU};
+static constexpr uint32_t kMsgOutNavRelposnedUart1{0x2091008EU};
+static constexpr uint32_t kMsgOutNavRelposnedUart2{0x2091008FU};
+static constexpr uint32_t kMsgOutNavRelposnedUsb{0x20910090U};
+static constexpr uint32_t kMsgOutNavRelposnedSpi{0x20910091U};
+
+// CFG-<port>OUTPROT-NMEA, L
+static constexpr uint32_t kI2cOutProtNmea{0x10720002U};
+static constexpr uint32_t kUart1OutProtNmea{0x10740002U};
+static constexpr uint32_t kUart2OutProtNmea{0x10760002U};
+static constexpr uint32_t kUsbOutProtNmea{0x10780002U};
+static constexpr uint32_t kSpiOutProtNmea{0x107A0002U};
+} // namespace key
+
+// CFG-VALSET layers, a bitmask
+enum class Layer : uint8_t {
+    kRam = 0x01U,
+    kBbr = 0x02U,
+    kFlash = 0x04U,
+};
+
+// CFG-VALGET polls a single layer, by number rather than by bit
+enum class ValgetLayer : uint8_t {
+    kRam = 0U,
+    kBbr = 1U,
+    kFlash = 2U,
+    kDefault = 7U,
+};
+
+enum class Port : uint8_t {
+    kI2c,
+    kUart1,
+    kUart2,
+    kUsb,
+    kSpi,
+};
+
+struct KeyValue {
+    uint32_t key;
+    uint64_t value;
+};
+
+// output rate of one message on a set of ports; 0 disables it
+struct MessageRate {
+    // keys of the message's CFG-MSGOUT item, indexed by Port
+    uint32_t keys[5];
+    uint8_t rate;
+};
+
+static constexpr MessageRate kNavPvt{{key::kMsgOutNavPvtI2c, key::kMsgOutNavPvtUart1,
+                                      key::kMsgOutNavPvtUart2, key::kMsgOutNavPvtUsb,
+                                      key::kMsgOutNavPvtSpi},
+                                     1U};
+
+static constexpr MessageRate kNavHpposllh{{key::kMsgOutNavHpposllhI2c, key::kMsgOutNavHpposllhUart1,
+                                           key::kMsgOutNavHpposllhUart2, key::kMsgOutNavHpposllhUsb,
+                                           key::kMsgOutNavHpposllhSpi},
+                                          1U};
+
+static constexpr MessageRate kNavRelposned{{key::kMsgOutNavRelposnedI2c, key::kMsgOutNavRelposnedUart1,
+                                            key::kMsgOutNavRelposnedUart2, key::kMsgOutNavRelposnedUsb,
+                                            key::kMsgOutNavRelposnedSpi},
+                                           1U};
+
+// what the HUD wants from the receiver, applied on every connect
+struct ReceiverProfile {
+    uint16_t meas_rate_ms{100U}; // clamped to 40 ms (25 Hz)
+    std::vector<Port> ports{Port::kUart1, Port::kUsb};
+    std::vector<MessageRate> messages{kNavPvt};
+    bool disable_nmea{true};
+    uint8_t layers{static_cast<uint8_t>(Layer::kRam)};
+};
+
+static constexpr uint16_t kMinMeasRateMs{40U};
+static constexpr size_t kMaxKeysPerMessage{64U};
+
+// value size in bytes of a key
+size_t valueSize(uint32_t key);
+
+std::vector<KeyValue> profileKeyValues(const ReceiverProfile& profile);
+
+// payloads (not frames) for the CFG messages
+std::vector<uint8_t> encodeValset(const std::vector<KeyValue>& values, uint8_t layers);
+std::vector<uint8_t> encodeValget(const std::vector<KeyValue>& keys, ValgetLayer layer = ValgetLayer::kRam);
+
+// parses a CFG-VALGET response payload
+bool decodeValget(const uint8_t* payload, size_t length, std::vector<KeyValue>& values);
+
+} // namespace ubx::cfg
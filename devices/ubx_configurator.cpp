@@ -0,0 +1,164 @@
+#include "ubx_configurator.h"
+
+#include <algorithm>
+
+#include "ubx_frame.h"
+
+namespace {
+
+constexpr size_t kPayloadOffset{6U};
+
+}
+
+UbxConfigurator::UbxConfigurator(SendFunction send, QObject* parent)
+    : QObject(parent)
+    , send_(std::move(send))
+    , timer_(this) // parented so it follows moveToThread
+{
+    timer_.setSingleShot(true);
+    connect(&timer_, &QTimer::timeout, this, &UbxConfigurator::onTimeout);
+}
+
+void UbxConfigurator::apply(const ubx::cfg::ReceiverProfile& profile)
+{
+    cancel();
+
+    const std::vector<ubx::cfg::KeyValue> values = ubx::cfg::profileKeyValues(profile);
+    meas_rate_ms_ = std::max(profile.meas_rate_ms, ubx::cfg::kMinMeasRateMs);
+
+    for (size_t begin = 0; begin < values.size(); begin += ubx::cfg::kMaxKeysPerMessage) {
+        const size_t end = std::min(values.size(), begin + ubx::cfg::kMaxKeysPerMessage);
+        const std::vector<ubx::cfg::KeyValue> chunk(values.begin() + begin, values.begin() + end);
+
+        queue_.push_back({MsgClassId::kUbxCfgValset,
+                          ubx::buildFrame(MsgClassId::kUbxCfgValset, ubx::cfg::encodeValset(chunk, profile.layers)),
+                          {}});
+        queue_.push_back({MsgClassId::kUbxCfgValget,
+                          ubx::buildFrame(MsgClassId::kUbxCfgValget, ubx::cfg::encodeValget(chunk, ubx::cfg::ValgetLayer::kRam)),
+                          chunk});
+    }
+
+    status_ = Status::kApplying;
+    sendFront();
+}
+
+void UbxConfigurator::cancel()
+{
+    timer_.stop();
+    queue_.clear();
+    if (status_ == Status::kApplying)
+        status_ = Status::kIdle;
+}
+
+QString UbxConfigurator::statusString() const
+{
+    switch (status_) {
+    case Status::kIdle:
+        return "CFG idle";
+    case Status::kApplying:
+        return "CFG applying";
+    case Status::kApplied:
+        return QString("CFG %1 Hz").arg(1000.0 / meas_rate_ms_, 0, 'f', 0);
+    case Status::kFailed:
+        return "CFG failed: " + error_;
+    }
+    return {};
+}
+
+void UbxConfigurator::handleFrame(MsgClassId id, const uint8_t* frame, size_t length)
+{
+    if (queue_.empty())
+        return;
+
+    const Request& front = queue_.front();
+    const uint8_t* payload = frame + kPayloadOffset;
+    const size_t payload_length = length - ubx::kFrameOverhead;
+
+    switch (id) {
+    case MsgClassId::kUbxCfgValget:
+        if (front.id == MsgClassId::kUbxCfgValget)
+            valget_received_ = checkValget(payload, payload_length);
+        break;
+
+    case MsgClassId::kUbxAckAck:
+    case MsgClassId::kUbxAckNak: {
+        if (payload_length != sizeof(UbxAckMsg))
+            return;
+        const uint16_t acked = static_cast<uint16_t>(payload[0] << 8 | payload[1]);
+        if (acked != static_cast<uint16_t>(front.id))
+            return;
+
+        if (id == MsgClassId::kUbxAckNak)
+            fail(front.id == MsgClassId::kUbxCfgValset ? "VALSET rejected" : "VALGET rejected");
+        else if (front.id == MsgClassId::kUbxCfgValget && !valget_received_)
+            fail("readback mismatch");
+        else
+            completeFront();
+    } break;
+
+    default:
+        break;
+    }
+}
+
+void UbxConfigurator::onTimeout()
+{
+    if (queue_.empty())
+        return;
+
+    if (queue_.front().attempts > max_retries_) {
+        fail("no ACK");
+        return;
+    }
+
+    ++total_retries_;
+    sendFront();
+}
+
+void UbxConfigurator::sendFront()
+{
+    if (queue_.empty()) {
+        status_ = Status::kApplied;
+        emit profileApplied();
+        return;
+    }
+
+    Request& front = queue_.front();
+    ++front.attempts;
+    valget_received_ = false;
+
+    // a failed write is treated like a lost frame and retried on timeout
+    send_(front.frame);
+    timer_.start(timeout_);
+}
+
+void UbxConfigurator::completeFront()
+{
+    timer_.stop();
+    queue_.pop_front();
+    sendFront();
+}
+
+void UbxConfigurator::fail(const QString& reason)
+{
+    timer_.stop();
+    queue_.clear();
+    status_ = Status::kFailed;
+    error_ = reason;
+    emit profileFailed(reason);
+}
+
+bool UbxConfigurator::checkValget(const uint8_t* payload, size_t length)
+{
+    std::vector<ubx::cfg::KeyValue> values;
+    if (!ubx::cfg::decodeValget(payload, length, values))
+        return false;
+
+    for (const ubx::cfg::KeyValue& expected : queue_.front().expected) {
+        const auto it = std::find_if(values.begin(), values.end(),
+                                     [&](const ubx::cfg::KeyValue& v) { return v.key == expected.key; });
+        if (it == values.end() || it->value != expected.value)
+            return false;
+    }
+    return true;
+}
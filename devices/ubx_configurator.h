@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "ubx_config.h"
+#include "ubx_types.h"
+
+// Sends CFG-VALSET / CFG-VALGET requests over whatever transport the owner
+// provides and matches them against ACK-ACK / ACK-NAK. Only one request is
+// in flight at a time, since an ACK only names the class and id it answers.
+// A request that gets no answer before the timeout is resent.
+class UbxConfigurator final : public QObject
+{
+    Q_OBJECT
+public:
+    using SendFunction = std::function<bool(const std::vector<uint8_t>& frame)>;
+
+    enum class Status {
+        kIdle,
+        kApplying,
+        kApplied,
+        kFailed,
+    };
+
+    explicit UbxConfigurator(SendFunction send, QObject* parent = nullptr);
+
+    void setTimeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
+    void setMaxRetries(int retries) { max_retries_ = retries; }
+
+    // writes the profile with CFG-VALSET, then reads it back with CFG-VALGET
+    // and checks the receiver took every value
+    void apply(const ubx::cfg::ReceiverProfile& profile);
+
+    // drops anything queued or in flight, e.g. when the link goes down
+    void cancel();
+
+    // feed every frame the parser accepts
+    void handleFrame(MsgClassId id, const uint8_t* frame, size_t length);
+
+    Status status() const { return status_; }
+    QString statusString() const;
+    uint32_t retries() const { return total_retries_; }
+
+signals:
+    void profileApplied();
+    void profileFailed(const QString& reason);
+
+private slots:
+    void onTimeout();
+
+private:
+    struct Request {
+        MsgClassId id;
+        std::vector<uint8_t> frame;
+        std::vector<ubx::cfg::KeyValue> expected; // VALGET only
+        int attempts = 0;
+    };
+
+    SendFunction send_;
+    QTimer timer_;
+    std::chrono::milliseconds timeout_{500};
+    int max_retries_ = 3;
+
+    std::deque<Request> queue_;
+    bool valget_received_ = false;
+    Status status_ = Status::kIdle;
+    QString error_;
+    uint32_t total_retries_ = 0U;
+    uint16_t meas_rate_ms_ = 0U;
+
+    void sendFront();
+    void completeFront();
+    void fail(const QString& reason);
+    bool checkValget(const uint8_t* payload, size_t length);
+};
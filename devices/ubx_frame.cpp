@@ -0,0 +1,71 @@
+#include "ubx_frame.h"
+
+namespace ubx {
+
+void checksum(const uint8_t* data, size_t length, uint8_t& ck_a, uint8_t& ck_b)
+{
+    ck_a = 0U;
+    ck_b = 0U;
+    for (size_t i = 0; i < length; ++i) {
+        ck_a += data[i];
+        ck_b += ck_a;
+    }
+}
+
+std::vector<uint8_t> buildFrame(MsgClassId id, const uint8_t* payload, size_t length)
+{
+    std::vector<uint8_t> frame;
+    frame.reserve(length + kFrameOverhead);
+
+    frame.push_back(kSynByte1);
+    frame.push_back(kSynByte2);
+    frame.push_back(static_cast<uint8_t>(static_cast<uint16_t>(id) >> 8));
+    frame.push_back(static_cast<uint8_t>(static_cast<uint16_t>(id) & 0xFFU));
+    frame.push_back(static_cast<uint8_t>(length & 0xFFU));
+    frame.push_back(static_cast<uint8_t>(length >> 8));
+    frame.insert(frame.end(), payload, payload + length);
+
+    uint8_t ck_a;
+    uint8_t ck_b;
+    checksum(frame.data() + 2, frame.size() - 2, ck_a, ck_b);
+    frame.push_back(ck_a);
+    frame.push_back(ck_b);
+    return frame;
+}
+
+size_t validFrameLength(const uint8_t* data, size_t size)
+{
+    if (size < kFrameOverhead || data[0] != kSynByte1 || data[1] != kSynByte2)
+        return 0U;
+
+    const size_t length = static_cast<size_t>(data[4]) | static_cast<size_t>(data[5]) << 8;
+    if (length + kFrameOverhead > size)
+        return 0U;
+
+    uint8_t ck_a;
+    uint8_t ck_b;
+    checksum(data + 2, length + 4, ck_a, ck_b);
+    if (ck_a != data[length + 6] || ck_b != data[length + 7])
+        return 0U;
+
+    return length + kFrameOverhead;
+}
+
+size_t findSyncPoint(const uint8_t* data, size_t size, size_t from)
+{
+    for (size_t offset = from; offset + 1 < size; ++offset) {
+        if (data[offset] != kSynByte1 || data[offset + 1] != kSynByte2)
+            continue;
+
+        const size_t length = validFrameLength(data + offset, size - offset);
+        if (length == 0U)
+            continue;
+
+        const size_t next = offset + length;
+        if (next == size || validFrameLength(data + next, size - next) != 0U)
+            return offset;
+    }
+    return size;
+}
+
+} // namespace ubx
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ubx_types.h"
+
+// Helpers for building outgoing UBX frames.
+namespace ubx {
+
+static constexpr size_t kFrameOverhead{8U}; // sync(2) class id length(2) checksum(2)
+
+// 8-bit Fletcher checksum over class, id, length and payload
+void checksum(const uint8_t* data, size_t length, uint8_t& ck_a, uint8_t& ck_b);
+
+std::vector<uint8_t> buildFrame(MsgClassId id, const uint8_t* payload, size_t length);
+
+inline std::vector<uint8_t> buildFrame(MsgClassId id, const std::vector<uint8_t>& payload)
+{
+    return buildFrame(id, payload.data(), payload.size());
+}
+
+// length of the checksum-valid frame starting at data, or 0 if there is none
+size_t validFrameLength(const uint8_t* data, size_t size);
+
+// First offset at or after `from` where a valid frame starts that is
+// followed by another valid frame (or the end of the data). Requiring two in
+// a row keeps sync bytes inside a payload from being mistaken for a frame
+// start. Returns size if there is no such point.
+size_t findSyncPoint(const uint8_t* data, size_t size, size_t from);
+
+} // namespace ubx
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <boost/endian/buffers.hpp> 
+#include <array>
+#include <cstdint>
+
+#include <boost/endian/buffers.hpp>
 
 static constexpr uint8_t kSynByte1{0xB5U};
 static constexpr uint8_t kSynByte2{0x62U};
@@ -13,7 +16,19 @@ using le_int16_t = boost::endian::little_int16_buf_t;
 
 enum class MsgClassId : uint16_t {
    kUbxNavPvt = 0x0107U,
+   kUbxNavHpposllh = 0x0114U,
+   kUbxNavRelposned = 0x013CU,
+   kUbxAckNak = 0x0500U,
+   kUbxAckAck = 0x0501U,
+   kUbxCfgValset = 0x068AU,
+   kUbxCfgValget = 0x068BU,
+   kUbxMgaIni = 0x1340U,
+
+};
 
+struct UbxAckMsg {
+    uint8_t cls_id; // class of the acknowledged message
+    uint8_t msg_id;
 };
 
 struct UbxNavPvtMsg {
@@ -84,3 +99,102 @@ struct UbxNavPvtMsg {
 
     
 };
+
+struct UbxNavHpposllhMsg {
+    union Flags {
+        struct {
+            uint8_t invalid_llh: 1;
+            uint8_t reserved: 7;
+        };
+        uint8_t word;
+    };
+
+    uint8_t version;
+    std::array<uint8_t, 2> reserved;
+    Flags flags;
+    le_uint32_t itow;
+    le_int32_t lon; // 1e-7 deg
+    le_int32_t lat;
+    le_int32_t height; // mm
+    le_int32_t height_msl;
+    int8_t lon_hp; // 1e-9 deg, -99..99
+    int8_t lat_hp;
+    int8_t height_hp; // 0.1 mm, -9..9
+    int8_t height_msl_hp;
+    le_uint32_t horizontal_acc; // 0.1 mm
+    le_uint32_t vertical_acc;
+};
+
+// relative position of the rover antenna to the (moving) base, version 0x01
+struct UbxNavRelposnedMsg {
+    union Flags {
+        struct {
+            uint32_t gnss_fix_ok: 1;
+            uint32_t diff_soln: 1;
+            uint32_t rel_pos_valid: 1;
+            uint32_t carr_soln: 2;
+            uint32_t is_moving: 1;
+            uint32_t ref_pos_miss: 1;
+            uint32_t ref_obs_miss: 1;
+            uint32_t rel_pos_heading_valid: 1;
+            uint32_t rel_pos_normalized: 1;
+            uint32_t reserved: 22;
+        };
+        uint32_t word;
+    };
+
+    uint8_t version;
+    uint8_t reserved0;
+    le_uint16_t ref_station_id;
+    le_uint32_t itow;
+    le_int32_t rel_pos_n; // cm
+    le_int32_t rel_pos_e;
+    le_int32_t rel_pos_d;
+    le_int32_t rel_pos_length;
+    le_int32_t rel_pos_heading; // 1e-5 deg
+    std::array<uint8_t, 4> reserved1;
+    int8_t rel_pos_hp_n; // 0.1 mm
+    int8_t rel_pos_hp_e;
+    int8_t rel_pos_hp_d;
+    int8_t rel_pos_hp_length;
+    le_uint32_t acc_n; // 0.1 mm
+    le_uint32_t acc_e;
+    le_uint32_t acc_d;
+    le_uint32_t acc_length;
+    le_uint32_t acc_heading; // 1e-5 deg
+    std::array<uint8_t, 4> reserved2;
+    Flags flags;
+};
+
+// MGA-INI-POS_LLH, an approximate position to start the search from
+struct UbxMgaIniPosLlhMsg {
+    uint8_t type{0x01U};
+    uint8_t version{};
+    std::array<uint8_t, 2> reserved{};
+    le_int32_t lat; // 1e-7 deg
+    le_int32_t lon;
+    le_int32_t alt; // cm above ellipsoid
+    le_uint32_t pos_acc; // cm
+};
+
+// MGA-INI-TIME_UTC, an approximate time; applied when it is received
+struct UbxMgaIniTimeUtcMsg {
+    uint8_t type{0x10U};
+    uint8_t version{};
+    uint8_t ref{}; // 0: on receipt of the message
+    int8_t leap_secs{-128}; // unknown
+    le_uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t reserved0{};
+    le_uint32_t ns;
+    le_uint16_t t_acc_s;
+    std::array<uint8_t, 2> reserved1{};
+    le_uint32_t t_acc_ns;
+};
+
+static_assert(sizeof(UbxMgaIniPosLlhMsg) == 20, "MGA-INI-POS_LLH layout changed");
+static_assert(sizeof(UbxMgaIniTimeUtcMsg) == 24, "MGA-INI-TIME_UTC layout changed");
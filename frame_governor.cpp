@@ -0,0 +1,146 @@
+#include "frame_governor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+const char* detailName(FrameGovernor::Detail detail)
+{
+    switch (detail) {
+    case FrameGovernor::Detail::kFull: return "full";
+    case FrameGovernor::Detail::kReduced: return "reduced";
+    case FrameGovernor::Detail::kMinimal: return "minimal";
+    }
+    return "";
+}
+
+const char* reasonName(FrameGovernor::Reason reason)
+{
+    switch (reason) {
+    case FrameGovernor::Reason::kNominal: return "nominal";
+    case FrameGovernor::Reason::kOverBudget: return "over budget";
+    case FrameGovernor::Reason::kThermal: return "thermal";
+    case FrameGovernor::Reason::kStationary: return "stationary";
+    }
+    return "";
+}
+
+} // namespace
+
+void FrameGovernor::recordUpdate(std::chrono::nanoseconds cost)
+{
+    update_ewma_ns_ += config_.smoothing * (static_cast<double>(cost.count()) - update_ewma_ns_);
+}
+
+void FrameGovernor::recordPaint(std::chrono::nanoseconds cost)
+{
+    paint_ewma_ns_ += config_.smoothing * (static_cast<double>(cost.count()) - paint_ewma_ns_);
+}
+
+void FrameGovernor::setSpeed(float speed_mps, std::chrono::steady_clock::time_point now)
+{
+    if (speed_mps >= config_.moving_speed_mps) {
+        slow_ = false;
+        stationary_ = false;
+        return;
+    }
+
+    if (speed_mps <= config_.stationary_speed_mps) {
+        if (!slow_) {
+            slow_ = true;
+            slow_since_ = now;
+        }
+        stationary_ = now - slow_since_ >= config_.stationary_hold;
+    }
+}
+
+void FrameGovernor::setTemperature(double celsius)
+{
+    if (std::isnan(celsius))
+        return;
+
+    temperature_c_ = celsius;
+    if (celsius >= config_.thermal_limit_c)
+        hot_ = true;
+    else if (celsius <= config_.thermal_clear_c)
+        hot_ = false;
+}
+
+double FrameGovernor::budgetNs(size_t level) const
+{
+    return config_.levels[level].interval_ms * 1e6 * config_.budget_fraction;
+}
+
+bool FrameGovernor::evaluate()
+{
+    const size_t previous = level_;
+    const size_t slowest = config_.levels.size() - 1U;
+    const double cost = update_ewma_ns_ + paint_ewma_ns_;
+
+    if (cooldown_ > 0)
+        --cooldown_;
+
+    if (stationary_) {
+        if (!parked_) {
+            parked_ = true;
+            level_before_parking_ = level_;
+        }
+        level_ = std::max(level_, config_.stationary_level);
+        reason_ = Reason::kStationary;
+        headroom_run_ = 0;
+    } else if (parked_) {
+        // moving again: go straight back to where the cost measurements had us
+        parked_ = false;
+        level_ = level_before_parking_;
+        reason_ = level_ == 0U ? Reason::kNominal : Reason::kOverBudget;
+        cooldown_ = 5;
+    } else if (cost > budgetNs(level_) && level_ < slowest) {
+        // give the new rate a few frames to show its cost before stepping again
+        if (cooldown_ == 0) {
+            ++level_;
+            cooldown_ = 5;
+        }
+        reason_ = Reason::kOverBudget;
+        headroom_run_ = 0;
+    } else if (hot_ && level_ < slowest) {
+        if (cooldown_ == 0) {
+            ++level_;
+            cooldown_ = 25;
+        }
+        reason_ = Reason::kThermal;
+        headroom_run_ = 0;
+    } else if (level_ > 0U && !hot_ && cost < budgetNs(level_ - 1U) * config_.headroom_fraction) {
+        if (++headroom_run_ >= config_.headroom_frames) {
+            --level_;
+            headroom_run_ = 0;
+            cooldown_ = 5;
+        }
+        if (level_ == 0U)
+            reason_ = Reason::kNominal;
+    } else {
+        headroom_run_ = 0;
+        if (level_ == 0U)
+            reason_ = Reason::kNominal;
+    }
+
+    return level_ != previous;
+}
+
+std::string FrameGovernor::describe() const
+{
+    char text[96];
+    std::snprintf(text, sizeof(text), "UI %d ms %s (%s)  frame %.1f ms", intervalMs(), detailName(detail()),
+                  reasonName(reason_), frameCostMs());
+    return text;
+}
+
+double readSocTemperature()
+{
+    std::ifstream in("/sys/class/thermal/thermal_zone0/temp");
+    long millidegrees = 0;
+    if (!(in >> millidegrees))
+        return std::nan("");
+    return millidegrees / 1000.0;
+}
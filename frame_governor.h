@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Picks the UI refresh interval and how much detail the pages draw, from the
+// measured cost of each frame, the vehicle speed and the SoC temperature.
+//
+// Levels run from fastest/fullest (0) to slowest/sparest. The governor steps
+// down one level as soon as the smoothed frame cost exceeds its share of the
+// interval, and steps back up only after a run of frames with plenty of
+// headroom, so it does not oscillate around the budget. While the bike is
+// parked it drops straight to the stationary level.
+class FrameGovernor {
+    public:
+    enum class Detail : uint8_t {
+        kFull,    // every field, live seconds
+        kReduced, // no secondary readouts that change every tick
+        kMinimal, // primary readouts only
+    };
+
+    enum class Reason : uint8_t {
+        kNominal,
+        kOverBudget,
+        kThermal,
+        kStationary,
+    };
+
+    struct Level {
+        int interval_ms;
+        Detail detail;
+    };
+
+    struct Config {
+        std::array<Level, 4> levels{{{200, Detail::kFull},
+                                     {333, Detail::kFull},
+                                     {500, Detail::kReduced},
+                                     {1000, Detail::kMinimal}}};
+        size_t stationary_level{3U};
+
+        // share of the interval a frame (update + paint) may use
+        double budget_fraction{0.25};
+        // step up once cost stays below this share of the faster level's budget
+        double headroom_fraction{0.5};
+        int headroom_frames{10};
+        double smoothing{0.2}; // EWMA weight of the newest frame
+
+        float stationary_speed_mps{0.5f};
+        float moving_speed_mps{1.5f};
+        std::chrono::seconds stationary_hold{5};
+
+        // SoC temperature at which the Pi starts soft throttling
+        double thermal_limit_c{80.0};
+        double thermal_clear_c{75.0};
+    };
+
+    FrameGovernor() = default;
+    explicit FrameGovernor(const Config& config) : config_(config) {}
+
+    void recordUpdate(std::chrono::nanoseconds cost);
+    void recordPaint(std::chrono::nanoseconds cost);
+    void setSpeed(float speed_mps, std::chrono::steady_clock::time_point now);
+    void setTemperature(double celsius);
+
+    // applies everything recorded since the last call; true if the level changed
+    bool evaluate();
+
+    int intervalMs() const { return config_.levels[level_].interval_ms; }
+    Detail detail() const { return config_.levels[level_].detail; }
+    Reason reason() const { return reason_; }
+    double frameCostMs() const { return (update_ewma_ns_ + paint_ewma_ns_) * 1e-6; }
+    double temperature() const { return temperature_c_; }
+
+    std::string describe() const;
+
+    private:
+    Config config_;
+    size_t level_{};
+    Reason reason_{Reason::kNominal};
+
+    double update_ewma_ns_{};
+    double paint_ewma_ns_{};
+    int headroom_run_{};
+    int cooldown_{};
+
+    bool stationary_{};
+    bool parked_{};
+    size_t level_before_parking_{};
+    bool slow_{};
+    std::chrono::steady_clock::time_point slow_since_{};
+
+    double temperature_c_{};
+    bool hot_{};
+
+    double budgetNs(size_t level) const;
+};
+
+// reads the SoC temperature from sysfs, NaN if unavailable
+double readSocTemperature();
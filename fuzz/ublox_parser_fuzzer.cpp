@@ -0,0 +1,42 @@
+// libFuzzer target for UbloxParser. The first input byte seeds where the
+// rest is cut; the parser must agree with the reference decoder both on the
+// whole input and on the pieces, and must not touch memory it shouldn't
+// (build with -fsanitize=fuzzer,address,undefined, see CMakeLists.txt).
+//
+//   ublox-parser-fuzzer -max_len=4096 corpus/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ubx_reference.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size == 0U)
+        return 0;
+
+    const uint8_t seed = data[0];
+    const uint8_t* stream = data + 1;
+    const size_t length = size - 1U;
+
+    std::vector<size_t> cuts;
+    std::minstd_rand rng(seed + 1U);
+    for (size_t at = 0U; at < length;) {
+        at += 1U + rng() % (seed % 32U + 1U);
+        cuts.push_back(std::min(at, length));
+    }
+
+    const ubx_reference::Result expected = ubx_reference::decode(stream, length);
+    for (const auto& piece : {std::vector<size_t>{}, cuts}) {
+        const std::string diff = ubx_reference::compare(expected, ubx_reference::parse(stream, length, piece));
+        if (!diff.empty()) {
+            std::cerr << (piece.empty() ? "whole: " : "in pieces: ") << diff << "\n";
+            std::abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// ublox-parser-property: feeds UbloxParser randomized UBX streams and checks
+// it against the reference decoder, whole and cut at random points.
+//
+// Streams mix valid frames of the decoded messages, the same ids with the
+// wrong length, other messages, oversize headers and noise rich in sync
+// bytes, and then get bytes flipped, dropped and repeated. Every stream is
+// parsed whole, a byte at a time and in random pieces; all three must match
+// the reference exactly.
+//
+//   ublox-parser-property [ITERATIONS [SEED]]
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "devices/ubx_frame.h"
+#include "ubx_reference.h"
+
+namespace {
+
+using Rng = std::mt19937;
+
+size_t uniform(Rng& rng, size_t lo, size_t hi)
+{
+    return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+}
+
+std::vector<uint8_t> randomBytes(Rng& rng, size_t n)
+{
+    // sync bytes far more often than chance, so false starts happen
+    std::vector<uint8_t> bytes(n);
+    for (uint8_t& b : bytes) {
+        const size_t pick = uniform(rng, 0U, 9U);
+        b = pick == 0U ? kSynByte1 : pick == 1U ? kSynByte2 : static_cast<uint8_t>(uniform(rng, 0U, 255U));
+    }
+    return bytes;
+}
+
+void append(std::vector<uint8_t>& out, const std::vector<uint8_t>& bytes)
+{
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+std::vector<uint8_t> makeStream(Rng& rng)
+{
+    static const MsgClassId kDecoded[] = {MsgClassId::kUbxNavPvt, MsgClassId::kUbxNavHpposllh,
+                                          MsgClassId::kUbxNavRelposned};
+    static const size_t kDecodedLength[] = {sizeof(UbxNavPvtMsg), sizeof(UbxNavHpposllhMsg),
+                                            sizeof(UbxNavRelposnedMsg)};
+
+    std::vector<uint8_t> stream;
+    const size_t items = uniform(rng, 1U, 40U);
+    for (size_t i = 0; i < items; ++i) {
+        switch (uniform(rng, 0U, 5U)) {
+        case 0:
+        case 1: {
+            const size_t k = uniform(rng, 0U, 2U);
+            append(stream, ubx::buildFrame(kDecoded[k], randomBytes(rng, kDecodedLength[k])));
+        } break;
+        case 2: {
+            const size_t k = uniform(rng, 0U, 2U);
+            append(stream, ubx::buildFrame(kDecoded[k], randomBytes(rng, uniform(rng, 0U, 120U))));
+        } break;
+        case 3: {
+            const auto id = static_cast<MsgClassId>(uniform(rng, 0U, 0xFFFFU));
+            append(stream, ubx::buildFrame(id, randomBytes(rng, uniform(rng, 0U, UbloxParser::kMaxPacketSize))));
+        } break;
+        case 4: {
+            const size_t length = uniform(rng, UbloxParser::kMaxPacketSize + 1U, 0xFFFFU);
+            append(stream, {kSynByte1, kSynByte2, 0x01U, 0x07U, static_cast<uint8_t>(length),
+                            static_cast<uint8_t>(length >> 8)});
+            append(stream, randomBytes(rng, uniform(rng, 0U, 16U)));
+        } break;
+        default:
+            append(stream, randomBytes(rng, uniform(rng, 1U, 64U)));
+            break;
+        }
+    }
+
+    if (!stream.empty() && uniform(rng, 0U, 1U) == 0U) {
+        const size_t edits = uniform(rng, 1U, 8U);
+        for (size_t e = 0; e < edits && !stream.empty(); ++e) {
+            const size_t at = uniform(rng, 0U, stream.size() - 1U);
+            switch (uniform(rng, 0U, 2U)) {
+            case 0: stream[at] ^= static_cast<uint8_t>(1U << uniform(rng, 0U, 7U)); break;
+            case 1: stream.erase(stream.begin() + static_cast<std::ptrdiff_t>(at)); break;
+            default: stream.insert(stream.begin() + static_cast<std::ptrdiff_t>(at), stream[at]); break;
+            }
+        }
+    }
+
+    // end mid-frame now and then
+    if (!stream.empty() && uniform(rng, 0U, 3U) == 0U)
+        stream.resize(uniform(rng, 0U, stream.size()));
+    return stream;
+}
+
+std::vector<size_t> randomCuts(Rng& rng, size_t size)
+{
+    std::vector<size_t> cuts;
+    size_t at = 0U;
+    while (size > 0U && at < size) {
+        // mostly small pieces, sometimes a large one
+        at += uniform(rng, 0U, 3U) == 0U ? uniform(rng, 1U, 700U) : uniform(rng, 1U, 9U);
+        cuts.push_back(std::min(at, size));
+    }
+    return cuts;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const unsigned long iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000UL;
+    const unsigned long seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1UL;
+
+    Rng rng(static_cast<Rng::result_type>(seed));
+    UbloxParser::Stats totals;
+    uint64_t bytes = 0U;
+
+    for (unsigned long n = 0; n < iterations; ++n) {
+        const std::vector<uint8_t> stream = makeStream(rng);
+        const ubx_reference::Result expected = ubx_reference::decode(stream.data(), stream.size());
+
+        std::vector<size_t> bytewise(stream.size());
+        for (size_t i = 0; i < bytewise.size(); ++i)
+            bytewise[i] = i + 1U;
+
+        const std::vector<std::pair<const char*, std::vector<size_t>>> chunkings = {
+            {"whole", {}},
+            {"bytewise", bytewise},
+            {"random", randomCuts(rng, stream.size())},
+        };
+        for (const auto& [name, cuts] : chunkings) {
+            const std::string diff =
+                ubx_reference::compare(expected, ubx_reference::parse(stream.data(), stream.size(), cuts));
+            if (!diff.empty()) {
+                std::cerr << "iteration " << n << " (seed " << seed << "), " << name << ", " << stream.size()
+                          << " bytes: " << diff << "\n";
+                return 1;
+            }
+        }
+
+        totals.frames += expected.stats.frames;
+        totals.checksum_errors += expected.stats.checksum_errors;
+        totals.oversize += expected.stats.oversize;
+        totals.rejected += expected.stats.rejected;
+        bytes += stream.size();
+    }
+
+    std::cout << iterations << " streams, " << bytes << " bytes: " << totals.frames << " frames, "
+              << totals.checksum_errors << " checksum errors, " << totals.oversize << " oversize, "
+              << totals.rejected << " rejected; every chunking matched\n";
+    return 0;
+}
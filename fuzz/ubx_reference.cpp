@@ -0,0 +1,141 @@
+#include "ubx_reference.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace ubx_reference {
+
+namespace {
+
+// payload length of the messages the parser decodes, 0 for the rest
+size_t decodedLength(uint16_t id)
+{
+    switch (static_cast<MsgClassId>(id)) {
+    case MsgClassId::kUbxNavPvt: return sizeof(UbxNavPvtMsg);
+    case MsgClassId::kUbxNavHpposllh: return sizeof(UbxNavHpposllhMsg);
+    case MsgClassId::kUbxNavRelposned: return sizeof(UbxNavRelposnedMsg);
+    default: return 0U;
+    }
+}
+
+} // namespace
+
+Result decode(const uint8_t* data, size_t size)
+{
+    Result result;
+    size_t i = 0U;
+    while (i < size) {
+        if (data[i] != kSynByte1) {
+            ++i;
+            continue;
+        }
+        if (i + 1U >= size)
+            break;
+        if (data[i + 1U] != kSynByte2) {
+            ++i;
+            continue;
+        }
+
+        if (i + UbloxParser::kHeaderSize > size)
+            break;
+        const uint16_t id = static_cast<uint16_t>((data[i + 2U] << 8) | data[i + 3U]);
+        const size_t length = data[i + 4U] | (static_cast<size_t>(data[i + 5U]) << 8);
+        if (length > UbloxParser::kMaxPacketSize) {
+            ++result.stats.oversize;
+            i += UbloxParser::kHeaderSize;
+            continue;
+        }
+
+        const size_t ck = i + UbloxParser::kHeaderSize + length;
+        if (ck >= size)
+            break;
+        uint8_t a = 0U;
+        uint8_t b = 0U;
+        for (size_t k = i + 2U; k < ck; ++k) {
+            a = static_cast<uint8_t>(a + data[k]);
+            b = static_cast<uint8_t>(b + a);
+        }
+        if (data[ck] != a) {
+            ++result.stats.checksum_errors;
+            i = ck + 1U;
+            continue;
+        }
+        if (ck + 1U >= size)
+            break;
+        if (data[ck + 1U] != b) {
+            ++result.stats.checksum_errors;
+            i = ck + 2U;
+            continue;
+        }
+
+        ++result.stats.frames;
+        const size_t expected = decodedLength(id);
+        if (expected != 0U && length != expected)
+            ++result.stats.rejected;
+        else if (static_cast<MsgClassId>(id) == MsgClassId::kUbxNavPvt)
+            result.nav_pvt.assign(data + i + UbloxParser::kHeaderSize, data + ck);
+        result.frames.push_back(Frame{id, std::vector<uint8_t>(data + i, data + ck + 2U)});
+        i = ck + 2U;
+    }
+    return result;
+}
+
+Result parse(const uint8_t* data, size_t size, const std::vector<size_t>& cuts)
+{
+    Result result;
+    UbloxParser parser;
+    parser.setFrameHandler([&](MsgClassId id, const uint8_t* frame, size_t length) {
+        result.frames.push_back(Frame{static_cast<uint16_t>(id), std::vector<uint8_t>(frame, frame + length)});
+    });
+
+    size_t from = 0U;
+    for (const size_t cut : cuts) {
+        if (cut < from || cut > size)
+            continue;
+        parser.read_bytes(data + from, cut - from);
+        from = cut;
+    }
+    parser.read_bytes(data + from, size - from);
+
+    result.stats = parser.stats();
+    // the parser starts from a zeroed message; an all-zero one is as good
+    // as none
+    static const UbxNavPvtMsg kEmpty{};
+    if (std::memcmp(&parser.navPvt(), &kEmpty, sizeof(kEmpty)) != 0) {
+        const auto* p = reinterpret_cast<const uint8_t*>(&parser.navPvt());
+        result.nav_pvt.assign(p, p + sizeof(UbxNavPvtMsg));
+    }
+    return result;
+}
+
+std::string compare(const Result& expected, const Result& actual)
+{
+    std::ostringstream out;
+    const auto count = [&](const char* name, uint64_t e, uint64_t a) {
+        if (e != a)
+            out << name << " " << a << ", expected " << e << "; ";
+    };
+    count("frames", expected.stats.frames, actual.stats.frames);
+    count("checksum errors", expected.stats.checksum_errors, actual.stats.checksum_errors);
+    count("oversize", expected.stats.oversize, actual.stats.oversize);
+    count("rejected", expected.stats.rejected, actual.stats.rejected);
+    count("handed out", expected.frames.size(), actual.frames.size());
+
+    for (size_t i = 0; i < expected.frames.size() && i < actual.frames.size(); ++i) {
+        if (!(expected.frames[i] == actual.frames[i])) {
+            out << "frame " << i << " differs (id " << std::hex << expected.frames[i].id << " vs "
+                << actual.frames[i].id << std::dec << "); ";
+            break;
+        }
+    }
+
+    std::vector<uint8_t> nav_pvt = expected.nav_pvt;
+    if (!nav_pvt.empty() && std::all_of(nav_pvt.begin(), nav_pvt.end(), [](uint8_t b) { return b == 0U; }))
+        nav_pvt.clear();
+    if (nav_pvt != actual.nav_pvt)
+        out << "latest NAV-PVT differs; ";
+    return out.str();
+}
+
+} // namespace ubx_reference
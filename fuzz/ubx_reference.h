@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "devices/ublox_parser.h"
+
+// What UbloxParser is expected to make of a byte stream, written as a plain
+// scan over the whole buffer so it can't share a bug with the state
+// machine:
+//
+//  - a frame starts at B5 62; a B5 followed by anything else is skipped
+//  - a length above kMaxPacketSize counts as oversize and the scan resumes
+//    after the length field
+//  - a checksum byte that doesn't match counts one error and the scan
+//    resumes after that byte
+//  - a frame cut off by the end of the stream is dropped silently
+//  - a NAV-PVT, HPPOSLLH or RELPOSNED of the wrong length is rejected,
+//    but still handed out as a frame
+namespace ubx_reference {
+
+struct Frame {
+    uint16_t id{};
+    std::vector<uint8_t> bytes; // sync through checksum
+    bool operator==(const Frame&) const = default;
+};
+
+struct Result {
+    std::vector<Frame> frames;
+    UbloxParser::Stats stats;
+    std::vector<uint8_t> nav_pvt; // last accepted payload, empty if none
+};
+
+Result decode(const uint8_t* data, size_t size);
+
+// UbloxParser fed the stream in pieces ending at the given offsets
+// (ascending; the rest goes in one last piece)
+Result parse(const uint8_t* data, size_t size, const std::vector<size_t>& cuts);
+
+// empty if equal, else what differs
+std::string compare(const Result& expected, const Result& actual);
+
+} // namespace ubx_reference
@@ -0,0 +1,35 @@
+#include "gnss_shm.h"
+
+#include <iostream>
+
+#include "devices/ublox_parser.h"
+
+GnssShmPublisher::GnssShmPublisher(Config config)
+    : config_(config)
+{
+}
+
+bool GnssShmPublisher::open()
+{
+    if (!epochs_.open(gnss_shm::kEpochRingName, config_.epoch_slots, sizeof(gnss_shm::SharedEpoch))) {
+        std::cout << "shm: cannot create " << gnss_shm::kEpochRingName << "\n";
+        return false;
+    }
+
+    if (config_.publish_raw_frames &&
+        !frames_.open(gnss_shm::kFrameRingName, config_.frame_slots, UbloxParser::kMaxFrameSize))
+        std::cout << "shm: cannot create " << gnss_shm::kFrameRingName << "\n";
+
+    return true;
+}
+
+void GnssShmPublisher::publishEpoch(const UbxNavPvtMsg& pvt, int64_t rx_time_ns)
+{
+    const gnss_shm::SharedEpoch epoch{pvt};
+    epochs_.publish(static_cast<uint32_t>(gnss_shm::RecordType::kEpoch), &epoch, sizeof(epoch), rx_time_ns);
+}
+
+void GnssShmPublisher::publishRawFrame(const uint8_t* frame, size_t length, int64_t rx_time_ns)
+{
+    frames_.publish(static_cast<uint32_t>(gnss_shm::RecordType::kRawFrame), frame, length, rx_time_ns);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+#include "shm_ring.h"
+#include "devices/ubx_types.h"
+
+// Shared memory fan-out of the receiver stream, so local processes (logger,
+// camera overlay, telemetry) can follow it without opening their own TCP
+// connection to the receiver.
+namespace gnss_shm {
+
+// decoded epochs, one SharedEpoch per record
+static constexpr const char* kEpochRingName{"/motohud.epochs"};
+// every UBX frame as received, sync bytes through checksum
+static constexpr const char* kFrameRingName{"/motohud.frames"};
+
+enum class RecordType : uint32_t {
+    kEpoch = 1,
+    kRawFrame = 2,
+};
+
+struct SharedEpoch {
+    UbxNavPvtMsg nav_pvt;
+};
+
+} // namespace gnss_shm
+
+// Writer side owned by the HUD. Publishing is a copy into a ring slot and
+// never waits for readers.
+class GnssShmPublisher {
+    public:
+    struct Config {
+        uint32_t epoch_slots{1024U};  // ~40 s at 25 Hz
+        uint32_t frame_slots{4096U};
+        bool publish_raw_frames{false};
+    };
+
+    explicit GnssShmPublisher(Config config);
+
+    bool open();
+    bool publishesRawFrames() const { return frames_.isOpen(); }
+
+    void publishEpoch(const UbxNavPvtMsg& pvt, int64_t rx_time_ns);
+    void publishRawFrame(const uint8_t* frame, size_t length, int64_t rx_time_ns);
+
+    uint64_t epochsPublished() const { return epochs_.published(); }
+
+    private:
+    Config config_;
+    ShmRingWriter epochs_;
+    ShmRingWriter frames_;
+};
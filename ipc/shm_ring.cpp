@@ -0,0 +1,246 @@
+#include "shm_ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+size_t slotStride(uint32_t slot_size)
+{
+    const size_t unaligned = sizeof(shm_ring::SlotHeader) + slot_size;
+    return (unaligned + 63U) / 64U * 64U;
+}
+
+constexpr uint64_t writingVersion(uint64_t sequence) { return 2U * sequence + 1U; }
+constexpr uint64_t completeVersion(uint64_t sequence) { return 2U * sequence + 2U; }
+
+} // namespace
+
+ShmRingWriter::~ShmRingWriter()
+{
+    close();
+}
+
+bool ShmRingWriter::open(const std::string& name, uint32_t slot_count, uint32_t slot_size)
+{
+    close();
+
+    if (slot_count == 0U || (slot_count & (slot_count - 1U)) != 0U)
+        return false;
+
+    // start from a fresh segment so readers of a previous run notice
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const size_t stride = slotStride(slot_size);
+    const size_t size = sizeof(shm_ring::Header) + stride * slot_count;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    // the segment is zero filled, so every slot version starts at "never written"
+    header_ = new (map) shm_ring::Header{};
+    header_->version = shm_ring::kVersion;
+    header_->slot_count = slot_count;
+    header_->slot_size = slot_size;
+    header_->slot_stride = static_cast<uint32_t>(stride);
+    header_->writer_pid = static_cast<int32_t>(::getpid());
+    header_->open.store(1U, std::memory_order_relaxed);
+    header_->next_sequence.store(0U, std::memory_order_relaxed);
+
+    slots_ = static_cast<uint8_t*>(map) + sizeof(shm_ring::Header);
+    for (uint32_t i = 0; i < slot_count; ++i)
+        new (slots_ + stride * i) shm_ring::SlotHeader{};
+
+    // readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = shm_ring::kMagic;
+
+    name_ = name;
+    mapped_size_ = size;
+    return true;
+}
+
+void ShmRingWriter::close()
+{
+    if (!header_)
+        return;
+
+    header_->open.store(0U, std::memory_order_release);
+    ::munmap(header_, mapped_size_);
+    ::shm_unlink(name_.c_str());
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+bool ShmRingWriter::publish(uint32_t type, const void* data, size_t length, int64_t timestamp_ns)
+{
+    if (!header_ || length > header_->slot_size)
+        return false;
+
+    const uint64_t sequence = header_->next_sequence.load(std::memory_order_relaxed);
+    auto* slot = reinterpret_cast<shm_ring::SlotHeader*>(
+        slots_ + header_->slot_stride * (sequence & (header_->slot_count - 1U)));
+
+    slot->version.store(writingVersion(sequence), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->type = type;
+    slot->length = static_cast<uint32_t>(length);
+    slot->timestamp_ns = timestamp_ns;
+    std::memcpy(reinterpret_cast<uint8_t*>(slot) + sizeof(shm_ring::SlotHeader), data, length);
+
+    slot->version.store(completeVersion(sequence), std::memory_order_release);
+    header_->next_sequence.store(sequence + 1U, std::memory_order_release);
+    return true;
+}
+
+uint64_t ShmRingWriter::published() const
+{
+    return header_ ? header_->next_sequence.load(std::memory_order_relaxed) : 0U;
+}
+
+ShmRingReader::~ShmRingReader()
+{
+    close();
+}
+
+bool ShmRingReader::open(const std::string& name)
+{
+    close();
+
+    const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(shm_ring::Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    const auto* header = static_cast<const shm_ring::Header*>(map);
+    const size_t expected = sizeof(shm_ring::Header) +
+                            static_cast<size_t>(header->slot_stride) * header->slot_count;
+    if (header->magic != shm_ring::kMagic || header->version != shm_ring::kVersion ||
+        expected > static_cast<size_t>(st.st_size)) {
+        ::munmap(map, st.st_size);
+        return false;
+    }
+
+    header_ = header;
+    slots_ = static_cast<const uint8_t*>(map) + sizeof(shm_ring::Header);
+    mapped_size_ = static_cast<size_t>(st.st_size);
+    next_sequence_ = header_->next_sequence.load(std::memory_order_acquire);
+    lost_ = 0U;
+    return true;
+}
+
+void ShmRingReader::close()
+{
+    if (!header_)
+        return;
+
+    ::munmap(const_cast<shm_ring::Header*>(header_), mapped_size_);
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+bool ShmRingReader::writerAlive() const
+{
+    if (!header_ || header_->open.load(std::memory_order_acquire) == 0U)
+        return false;
+    return ::kill(header_->writer_pid, 0) == 0 || errno == EPERM;
+}
+
+const shm_ring::SlotHeader* ShmRingReader::slot(uint64_t sequence) const
+{
+    return reinterpret_cast<const shm_ring::SlotHeader*>(
+        slots_ + header_->slot_stride * (sequence & (header_->slot_count - 1U)));
+}
+
+void ShmRingReader::skipAhead()
+{
+    // resume half a ring behind the writer so the next read is not lapped
+    // again straight away
+    const uint64_t head = header_->next_sequence.load(std::memory_order_acquire);
+    const uint64_t resume = head > header_->slot_count / 2U ? head - header_->slot_count / 2U : 0U;
+    if (resume > next_sequence_) {
+        lost_ += resume - next_sequence_;
+        next_sequence_ = resume;
+    }
+}
+
+ShmRingReader::Status ShmRingReader::next(View& view)
+{
+    if (!header_)
+        return Status::kEmpty;
+
+    const shm_ring::SlotHeader* s = slot(next_sequence_);
+    const uint64_t version = s->version.load(std::memory_order_acquire);
+
+    if (version < completeVersion(next_sequence_))
+        return Status::kEmpty; // not written yet, or being written right now
+
+    if (version > completeVersion(next_sequence_)) {
+        skipAhead();
+        return Status::kOverrun;
+    }
+
+    view.sequence = next_sequence_;
+    view.type = s->type;
+    view.length = std::min(s->length, header_->slot_size);
+    view.timestamp_ns = s->timestamp_ns;
+    view.data = reinterpret_cast<const uint8_t*>(s) + sizeof(shm_ring::SlotHeader);
+    ++next_sequence_;
+    return Status::kOk;
+}
+
+bool ShmRingReader::stillValid(const View& view) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot(view.sequence)->version.load(std::memory_order_relaxed) == completeVersion(view.sequence);
+}
+
+ShmRingReader::Status ShmRingReader::read(View& view, uint8_t* buffer, size_t capacity)
+{
+    const Status status = next(view);
+    if (status != Status::kOk)
+        return status;
+
+    const size_t length = std::min<size_t>(view.length, capacity);
+    std::memcpy(buffer, view.data, length);
+    if (!stillValid(view)) {
+        ++lost_;
+        skipAhead();
+        return Status::kOverrun;
+    }
+
+    view.length = static_cast<uint32_t>(length);
+    view.data = buffer;
+    return Status::kOk;
+}
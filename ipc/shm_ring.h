@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Single writer, many reader ring of fixed size slots in POSIX shared memory.
+//
+// Every slot carries a version word used as a seqlock: while the writer
+// fills the slot for sequence n the version is 2n+1, once it is complete the
+// version is 2n+2. Readers map the segment read-only and never signal the
+// writer, so any number of them can attach without slowing it down. A
+// reader that falls more than a ring behind sees a newer version than the
+// one it asked for and is told how many records it lost.
+namespace shm_ring {
+
+static constexpr uint64_t kMagic{0x31474E4952484DULL}; // "MHRING1"
+static constexpr uint32_t kVersion{1U};
+
+struct alignas(64) Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size; // payload bytes per slot
+    uint32_t slot_stride;
+    int32_t writer_pid;
+    std::atomic<uint32_t> open; // cleared by the writer on a clean shutdown
+    alignas(64) std::atomic<uint64_t> next_sequence;
+};
+
+struct alignas(64) SlotHeader {
+    std::atomic<uint64_t> version;
+    uint32_t type;
+    uint32_t length;
+    int64_t timestamp_ns;
+};
+
+} // namespace shm_ring
+
+class ShmRingWriter {
+    public:
+    ShmRingWriter() = default;
+    ~ShmRingWriter();
+
+    ShmRingWriter(const ShmRingWriter&) = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    // creates (or replaces) the named segment; slot_count must be a power of two
+    bool open(const std::string& name, uint32_t slot_count, uint32_t slot_size);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    // never blocks; a record longer than the slot size is rejected
+    bool publish(uint32_t type, const void* data, size_t length, int64_t timestamp_ns);
+
+    uint64_t published() const;
+
+    private:
+    std::string name_;
+    shm_ring::Header* header_{};
+    uint8_t* slots_{};
+    size_t mapped_size_{};
+};
+
+class ShmRingReader {
+    public:
+    enum class Status {
+        kOk,
+        kEmpty,   // caught up with the writer
+        kOverrun, // the writer lapped this reader, see lost()
+    };
+
+    // a record viewed in place inside the shared mapping
+    struct View {
+        uint64_t sequence;
+        uint32_t type;
+        uint32_t length;
+        int64_t timestamp_ns;
+        const uint8_t* data;
+    };
+
+    ShmRingReader() = default;
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    // attaches to an existing segment and starts at the newest record
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    // false once the writer has shut down or its process is gone
+    bool writerAlive() const;
+
+    // Zero copy: points `view` at the next record in the mapping. The writer
+    // may overwrite it at any time, so after using the data call
+    // stillValid(view) and discard whatever was derived from it if that
+    // returns false.
+    Status next(View& view);
+    bool stillValid(const View& view) const;
+
+    // copying variant; the record is consistent when kOk is returned
+    Status read(View& view, uint8_t* buffer, size_t capacity);
+
+    uint64_t lost() const { return lost_; }
+
+    private:
+    const shm_ring::Header* header_{};
+    const uint8_t* slots_{};
+    size_t mapped_size_{};
+    uint64_t next_sequence_{};
+    uint64_t lost_{};
+
+    const shm_ring::SlotHeader* slot(uint64_t sequence) const;
+    void skipAhead();
+};
@@ -0,0 +1,25 @@
+#include "ride_log_format.h"
+
+#include <boost/crc.hpp>
+
+namespace ride_log {
+
+uint32_t recordCrc(const RecordHeader& header, const uint8_t* payload)
+{
+    RecordHeader copy = header;
+    copy.crc = 0U;
+
+    boost::crc_32_type crc;
+    crc.process_bytes(&copy, sizeof(copy));
+    crc.process_bytes(payload, header.length);
+    return crc.checksum();
+}
+
+uint32_t fileHeaderCrc(const FileHeader& header)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(&header, offsetof(FileHeader, header_crc));
+    return crc.checksum();
+}
+
+} // namespace ride_log
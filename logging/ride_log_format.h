@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of a ride log (.mhl).
+//
+// A file starts with one block holding a FileHeader, zero padded to the block
+// size. Records follow back to back; each is a RecordHeader plus `length`
+// payload bytes. Records may straddle block boundaries, but every write ends
+// on a block boundary and the unused tail of the last block is zero filled.
+// A zero magic therefore means "skip to the next block", and anything else
+// that fails validation marks the end of the usable data (torn write).
+
+namespace ride_log {
+
+static constexpr uint64_t kFileMagic{0x31474F4C44484D00ULL}; // "\0MHDLOG1"
+static constexpr uint16_t kRecordMagic{0x4D52U};              // "RM"
+static constexpr uint16_t kFormatVersion{1U};
+static constexpr const char* kFileExtension{".mhl"};
+
+enum class RecordType : uint8_t {
+    kEpoch = 1,    // payload is a UbxNavPvtMsg
+    kRawFrame = 2, // payload is a complete UBX frame, sync bytes included
+};
+
+struct FileHeader {
+    uint64_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t block_size;
+    int64_t created_unix_ns;
+    uint32_t sequence;  // rotation counter within a session
+    uint32_t header_crc; // crc32 of the preceding fields
+};
+
+struct RecordHeader {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t length;
+    uint16_t reserved2;
+    int64_t rx_time_ns; // steady clock at receipt
+    uint32_t sequence;
+    uint32_t crc; // crc32 of this header (crc = 0) followed by the payload
+};
+
+static_assert(sizeof(RecordHeader) == 24, "record header layout changed");
+
+uint32_t recordCrc(const RecordHeader& header, const uint8_t* payload);
+uint32_t fileHeaderCrc(const FileHeader& header);
+
+inline size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace ride_log
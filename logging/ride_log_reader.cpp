@@ -0,0 +1,140 @@
+#include "ride_log_reader.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+RideLogReader::RideLogReader(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ride_log::FileHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return;
+
+    std::memcpy(&header_, map, sizeof(header_));
+    if (header_.magic != ride_log::kFileMagic ||
+        header_.header_crc != ride_log::fileHeaderCrc(header_) ||
+        header_.block_size == 0U) {
+        ::munmap(map, st.st_size);
+        return;
+    }
+
+    ::madvise(map, st.st_size, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+    offset_ = header_.block_size;
+    valid_end_ = std::min<size_t>(offset_, size_);
+}
+
+RideLogReader::~RideLogReader()
+{
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+bool RideLogReader::next(Record& record)
+{
+    if (!data_)
+        return false;
+
+    while (offset_ + sizeof(ride_log::RecordHeader) <= size_) {
+        ride_log::RecordHeader header;
+        std::memcpy(&header, data_ + offset_, sizeof(header));
+
+        if (header.magic == 0U) {
+            // zero padding, the next record starts on a block boundary
+            offset_ = ride_log::alignUp(offset_ + 1, header_.block_size);
+            continue;
+        }
+
+        const uint8_t* payload = data_ + offset_ + sizeof(header);
+        if (header.magic != ride_log::kRecordMagic ||
+            offset_ + sizeof(header) + header.length > size_ ||
+            header.crc != ride_log::recordCrc(header, payload)) {
+            torn_tail_ = true;
+            offset_ = size_;
+            return false;
+        }
+
+        record.type = static_cast<ride_log::RecordType>(header.type);
+        record.sequence = header.sequence;
+        record.rx_time_ns = header.rx_time_ns;
+        record.payload = payload;
+        record.length = header.length;
+
+        offset_ += sizeof(header) + header.length;
+        valid_end_ = offset_;
+        return true;
+    }
+
+    offset_ = size_;
+    return false;
+}
+
+namespace ride_log {
+
+bool recoverFile(const std::filesystem::path& path, RecoveryResult& result)
+{
+    result = RecoveryResult{};
+
+    size_t valid_end = 0U;
+    size_t block_size = 0U;
+    size_t file_size = 0U;
+    {
+        RideLogReader reader(path);
+        if (!reader.isOpen())
+            return false;
+
+        RideLogReader::Record record;
+        while (reader.next(record))
+            ++result.records;
+
+        valid_end = reader.validEnd();
+        block_size = reader.header().block_size;
+        file_size = std::filesystem::file_size(path);
+    }
+
+    const size_t keep = std::min(alignUp(valid_end, block_size), file_size);
+    result.kept_bytes = keep;
+    result.discarded_bytes = file_size - keep;
+
+    if (keep == valid_end && keep == file_size)
+        return true;
+
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    bool ok = true;
+    if (keep > valid_end) {
+        const std::vector<uint8_t> zeros(keep - valid_end, 0U);
+        ok = ::pwrite(fd, zeros.data(), zeros.size(), static_cast<off_t>(valid_end)) ==
+             static_cast<ssize_t>(zeros.size());
+    }
+    ok = ok && ::ftruncate(fd, static_cast<off_t>(keep)) == 0;
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (ok && result.discarded_bytes > 0U) {
+        std::cout << "ride log recovered: " << path << " kept " << keep << " bytes, dropped "
+                  << result.discarded_bytes << "\n";
+    }
+    return ok;
+}
+
+} // namespace ride_log
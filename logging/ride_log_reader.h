@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "ride_log_format.h"
+
+// Sequential, zero-copy reader for a ride log. The file is memory mapped and
+// records point straight into the mapping, so they are only valid while the
+// reader is alive.
+class RideLogReader {
+    public:
+    struct Record {
+        ride_log::RecordType type;
+        uint32_t sequence;
+        int64_t rx_time_ns;
+        const uint8_t* payload;
+        uint16_t length;
+    };
+
+    explicit RideLogReader(const std::filesystem::path& path);
+    ~RideLogReader();
+
+    RideLogReader(const RideLogReader&) = delete;
+    RideLogReader& operator=(const RideLogReader&) = delete;
+
+    bool isOpen() const { return data_ != nullptr; }
+    const ride_log::FileHeader& header() const { return header_; }
+
+    // false once the end of the valid data is reached
+    bool next(Record& record);
+
+    // offset just past the last valid record, and whether anything other than
+    // zero padding follows it (a torn write)
+    size_t validEnd() const { return valid_end_; }
+    bool hasTornTail() const { return torn_tail_; }
+
+    private:
+    const uint8_t* data_{};
+    size_t size_{};
+    size_t offset_{};
+    size_t valid_end_{};
+    bool torn_tail_{};
+    ride_log::FileHeader header_{};
+};
+
+namespace ride_log {
+
+struct RecoveryResult {
+    size_t records{};
+    size_t kept_bytes{};
+    size_t discarded_bytes{};
+};
+
+// Scans a log left behind by an unclean shutdown, zeroes any torn record in
+// its last block and truncates everything past that block, leaving a file
+// that reads cleanly to the end.
+bool recoverFile(const std::filesystem::path& path, RecoveryResult& result);
+
+} // namespace ride_log
@@ -0,0 +1,394 @@
+#include "ride_logger.h"
+
+#include "ride_log_reader.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+uint32_t elapsedUs(std::chrono::steady_clock::time_point since)
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since);
+    return static_cast<uint32_t>(us.count());
+}
+
+void updateMax(std::atomic<uint32_t>& max, uint32_t value)
+{
+    uint32_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t length)
+{
+    while (length > 0U) {
+        const ssize_t n = ::write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void syncDirectory(const std::filesystem::path& directory)
+{
+    const int dir_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
+} // namespace
+
+RideLogger::RideLogger(Config config)
+    : config_(std::move(config))
+    , buffer_(nullptr, std::free)
+{
+    // a buffer that can take flush_bytes plus one worst case record without
+    // wrapping, rounded to whole blocks
+    buffer_capacity_ = ride_log::alignUp(config_.flush_bytes + sizeof(ride_log::RecordHeader) +
+                                             UbloxParser::kMaxFrameSize + config_.block_size,
+                                         config_.block_size);
+}
+
+RideLogger::~RideLogger()
+{
+    stop();
+}
+
+bool RideLogger::start()
+{
+    if (running_.load())
+        return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec) {
+        std::cout << "ride logger: cannot create " << config_.directory << ": " << ec.message() << "\n";
+        return false;
+    }
+
+    buffer_.reset(static_cast<uint8_t*>(std::aligned_alloc(config_.block_size, buffer_capacity_)));
+    if (!buffer_)
+        return false;
+    buffered_ = 0U;
+
+    recoverPrevious();
+
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    ::gmtime_r(&now, &utc);
+    char name[32];
+    std::strftime(name, sizeof(name), "ride-%Y%m%d-%H%M%S", &utc);
+    session_name_ = name;
+    file_sequence_ = 0U;
+
+    if (!openFile())
+        return false;
+
+    stopping_.store(false);
+    running_.store(true);
+    thread_ = std::thread(&RideLogger::run, this);
+    return true;
+}
+
+void RideLogger::stop()
+{
+    if (!running_.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_.store(true);
+    }
+    wake_.notify_one();
+    thread_.join();
+    running_.store(false);
+}
+
+bool RideLogger::logEpoch(const UbxNavPvtMsg& pvt, int64_t rx_time_ns)
+{
+    Entry entry;
+    entry.type = ride_log::RecordType::kEpoch;
+    entry.length = sizeof(pvt);
+    entry.rx_time_ns = rx_time_ns;
+    std::memcpy(entry.data.data(), &pvt, sizeof(pvt));
+    return push(entry);
+}
+
+bool RideLogger::logRawFrame(const uint8_t* frame, size_t length, int64_t rx_time_ns)
+{
+    if (!config_.log_raw_frames || length > UbloxParser::kMaxFrameSize)
+        return false;
+
+    Entry entry;
+    entry.type = ride_log::RecordType::kRawFrame;
+    entry.length = static_cast<uint16_t>(length);
+    entry.rx_time_ns = rx_time_ns;
+    std::memcpy(entry.data.data(), frame, length);
+    return push(entry);
+}
+
+bool RideLogger::push(const Entry& entry)
+{
+    if (!running_.load(std::memory_order_relaxed) || !queue_.push(entry)) {
+        records_dropped_.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+
+    records_queued_.fetch_add(1U, std::memory_order_relaxed);
+    // write_available() is for the producer only, so metrics() reads this
+    const size_t depth = kQueueCapacity - queue_.write_available();
+    queue_depth_.store(depth, std::memory_order_relaxed);
+    if (depth > queue_high_water_.load(std::memory_order_relaxed))
+        queue_high_water_.store(depth, std::memory_order_relaxed);
+    return true;
+}
+
+RideLogger::Metrics RideLogger::metrics() const
+{
+    Metrics m;
+    m.queue_capacity = kQueueCapacity;
+    m.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+    m.queue_high_water = queue_high_water_.load(std::memory_order_relaxed);
+    m.records_queued = records_queued_.load(std::memory_order_relaxed);
+    m.records_dropped = records_dropped_.load(std::memory_order_relaxed);
+    m.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+    m.writes = writes_.load(std::memory_order_relaxed);
+    m.syncs = syncs_.load(std::memory_order_relaxed);
+    m.write_errors = write_errors_.load(std::memory_order_relaxed);
+    m.last_write_us = last_write_us_.load(std::memory_order_relaxed);
+    m.max_write_us = max_write_us_.load(std::memory_order_relaxed);
+    m.last_sync_us = last_sync_us_.load(std::memory_order_relaxed);
+    m.max_sync_us = max_sync_us_.load(std::memory_order_relaxed);
+    m.files_opened = files_opened_.load(std::memory_order_relaxed);
+    return m;
+}
+
+void RideLogger::run()
+{
+    last_flush_ = Clock::now();
+    last_sync_ = last_flush_;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, config_.drain_interval, [this] { return stopping_.load(); });
+        }
+        const bool stopping = stopping_.load();
+
+        drain();
+
+        const auto now = Clock::now();
+        if (buffered_ > 0U && (stopping || now - last_flush_ >= config_.flush_interval))
+            writeBlocks(true);
+
+        if (dirty_ && (stopping || config_.sync_policy == SyncPolicy::kEveryFlush ||
+                       (config_.sync_policy == SyncPolicy::kInterval &&
+                        now - last_sync_ >= config_.sync_interval)))
+            sync();
+
+        if (stopping)
+            break;
+
+        if (fd_ >= 0 && (file_bytes_ >= config_.rotate_bytes || now - file_opened_ >= config_.rotate_interval)) {
+            writeBlocks(true);
+            sync();
+            closeFile();
+            ++file_sequence_;
+            openFile();
+        }
+    }
+
+    closeFile();
+}
+
+void RideLogger::drain()
+{
+    queue_.consume_all([this](const Entry& entry) { append(entry); });
+}
+
+void RideLogger::append(const Entry& entry)
+{
+    ride_log::RecordHeader header{};
+    header.magic = ride_log::kRecordMagic;
+    header.type = static_cast<uint8_t>(entry.type);
+    header.length = entry.length;
+    header.rx_time_ns = entry.rx_time_ns;
+    header.sequence = record_sequence_++;
+    header.crc = ride_log::recordCrc(header, entry.data.data());
+
+    uint8_t* out = buffer_.get() + buffered_;
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), entry.data.data(), entry.length);
+    buffered_ += sizeof(header) + entry.length;
+
+    if (buffered_ >= config_.flush_bytes)
+        writeBlocks(false);
+}
+
+void RideLogger::writeBlocks(bool pad)
+{
+    if (buffered_ == 0U)
+        return;
+
+    size_t length = buffered_ / config_.block_size * config_.block_size;
+    if (pad) {
+        length = ride_log::alignUp(buffered_, config_.block_size);
+        std::memset(buffer_.get() + buffered_, 0, length - buffered_);
+        last_flush_ = Clock::now();
+    }
+    if (length == 0U)
+        return;
+
+    // a failed rotation left no file; try again for every batch rather
+    // than waiting out the next rotation
+    if (fd_ < 0 && !openFile())
+        write_errors_.fetch_add(1U, std::memory_order_relaxed);
+
+    if (fd_ >= 0) {
+        const auto begin = Clock::now();
+        const bool ok = writeAll(fd_, buffer_.get(), length);
+        const uint32_t us = elapsedUs(begin);
+
+        last_write_us_.store(us, std::memory_order_relaxed);
+        updateMax(max_write_us_, us);
+        writes_.fetch_add(1U, std::memory_order_relaxed);
+
+        if (ok) {
+            bytes_written_.fetch_add(length, std::memory_order_relaxed);
+            file_bytes_ += length;
+            dirty_ = true;
+        } else {
+            // keep the file block aligned for the next attempt; the data in
+            // this batch is lost either way
+            write_errors_.fetch_add(1U, std::memory_order_relaxed);
+            std::cout << "ride logger: write failed: " << std::strerror(errno) << "\n";
+            ::lseek(fd_, static_cast<off_t>(file_bytes_), SEEK_SET);
+        }
+    }
+
+    const size_t remaining = pad ? 0U : buffered_ - length;
+    std::memmove(buffer_.get(), buffer_.get() + length, remaining);
+    buffered_ = remaining;
+
+    if (config_.sync_policy == SyncPolicy::kEveryFlush && pad)
+        sync();
+}
+
+void RideLogger::sync()
+{
+    if (fd_ < 0 || !dirty_)
+        return;
+
+    const auto begin = Clock::now();
+    ::fdatasync(fd_);
+    const uint32_t us = elapsedUs(begin);
+
+    last_sync_us_.store(us, std::memory_order_relaxed);
+    updateMax(max_sync_us_, us);
+    syncs_.fetch_add(1U, std::memory_order_relaxed);
+    last_sync_ = Clock::now();
+    dirty_ = false;
+}
+
+bool RideLogger::openFile()
+{
+    std::filesystem::path path;
+    int fd = -1;
+    // never reuse a name: the Pi has no RTC and may boot with a stale clock
+    for (uint32_t attempt = 0U; fd < 0 && attempt < 1000U; ++attempt) {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "-%03u", file_sequence_);
+        path = config_.directory / (session_name_ + suffix + ride_log::kFileExtension);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0 && errno == EEXIST)
+            ++file_sequence_;
+        else if (fd < 0)
+            break;
+    }
+
+    if (fd < 0) {
+        std::cout << "ride logger: cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    ride_log::FileHeader header{};
+    header.magic = ride_log::kFileMagic;
+    header.version = ride_log::kFormatVersion;
+    header.block_size = static_cast<uint32_t>(config_.block_size);
+    header.created_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+    header.sequence = file_sequence_;
+    header.header_crc = ride_log::fileHeaderCrc(header);
+
+    std::unique_ptr<uint8_t, void (*)(void*)> block(
+        static_cast<uint8_t*>(std::aligned_alloc(config_.block_size, config_.block_size)), std::free);
+    std::memset(block.get(), 0, config_.block_size);
+    std::memcpy(block.get(), &header, sizeof(header));
+
+    // the header must be durable before any record refers to this file
+    if (!writeAll(fd, block.get(), config_.block_size) || ::fdatasync(fd) != 0) {
+        std::cout << "ride logger: cannot write header to " << path << "\n";
+        ::close(fd);
+        return false;
+    }
+    syncDirectory(config_.directory);
+
+    fd_ = fd;
+    file_bytes_ = config_.block_size;
+    file_opened_ = Clock::now();
+    record_sequence_ = 0U;
+    dirty_ = false;
+    files_opened_.fetch_add(1U, std::memory_order_relaxed);
+    return true;
+}
+
+void RideLogger::closeFile()
+{
+    if (fd_ < 0)
+        return;
+
+    sync();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void RideLogger::recoverPrevious()
+{
+    // only the newest file can have been cut off mid-write; pick it by mtime
+    // because names depend on a clock that may have been wrong at the time
+    std::filesystem::path newest;
+    std::filesystem::file_time_type newest_time{};
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ride_log::kFileExtension)
+            continue;
+        const auto t = entry.last_write_time(ec);
+        if (!ec && (newest.empty() || t > newest_time)) {
+            newest = entry.path();
+            newest_time = t;
+        }
+    }
+
+    if (newest.empty())
+        return;
+
+    ride_log::RecoveryResult result;
+    if (!ride_log::recoverFile(newest, result))
+        std::cout << "ride logger: could not recover " << newest << "\n";
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include "ride_log_format.h"
+#include "devices/ubx_types.h"
+#include "devices/ublox_parser.h"
+
+// Records decoded epochs (and optionally every raw UBX frame) to the SD card.
+//
+// The receive path only copies into a lock-free single producer queue and
+// never waits; a background thread drains it into a block aligned buffer and
+// writes whole blocks, so the card sees few large sequential writes instead
+// of one small write per epoch. See ride_log_format.h for the file layout.
+class RideLogger {
+    public:
+    enum class SyncPolicy : uint8_t {
+        kNever,      // leave it to the kernel's writeback
+        kEveryFlush, // fdatasync after every write
+        kInterval,   // fdatasync at most every sync_interval
+    };
+
+    struct Config {
+        std::filesystem::path directory;
+        bool log_raw_frames{false};
+
+        size_t block_size{4096U};
+        // full blocks are written as soon as this much data is buffered
+        size_t flush_bytes{64U * 1024U};
+        // buffered data older than this is padded out to a block and written
+        std::chrono::milliseconds flush_interval{2000};
+        // how often the writer thread wakes to drain the queue
+        std::chrono::milliseconds drain_interval{100};
+
+        SyncPolicy sync_policy{SyncPolicy::kInterval};
+        std::chrono::milliseconds sync_interval{10000};
+
+        size_t rotate_bytes{64U * 1024U * 1024U};
+        std::chrono::minutes rotate_interval{60};
+    };
+
+    struct Metrics {
+        size_t queue_depth{};
+        size_t queue_high_water{};
+        size_t queue_capacity{};
+        uint64_t records_queued{};
+        uint64_t records_dropped{};
+        uint64_t bytes_written{};
+        uint64_t writes{};
+        uint64_t syncs{};
+        uint64_t write_errors{};
+        uint32_t last_write_us{};
+        uint32_t max_write_us{};
+        uint32_t last_sync_us{};
+        uint32_t max_sync_us{};
+        uint32_t files_opened{};
+    };
+
+    explicit RideLogger(Config config);
+    ~RideLogger();
+
+    RideLogger(const RideLogger&) = delete;
+    RideLogger& operator=(const RideLogger&) = delete;
+
+    // recovers the most recent log left by a previous run, opens a new file
+    // and starts the writer thread
+    bool start();
+    // drains the queue, writes and syncs everything, and joins the thread
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_relaxed); }
+
+    // producer side, called from the receive path; never blocks, and drops
+    // the record (counted in Metrics) when the queue is full
+    bool logEpoch(const UbxNavPvtMsg& pvt, int64_t rx_time_ns);
+    bool logRawFrame(const uint8_t* frame, size_t length, int64_t rx_time_ns);
+    bool logsRawFrames() const { return config_.log_raw_frames; }
+
+    Metrics metrics() const;
+
+    private:
+    static constexpr size_t kQueueCapacity{1024U};
+
+    struct Entry {
+        ride_log::RecordType type;
+        uint16_t length;
+        int64_t rx_time_ns;
+        std::array<uint8_t, UbloxParser::kMaxFrameSize> data;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    Config config_;
+    boost::lockfree::spsc_queue<Entry, boost::lockfree::capacity<kQueueCapacity>> queue_;
+
+    std::thread thread_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+
+    // writer thread state
+    int fd_{-1};
+    uint32_t file_sequence_{};
+    uint32_t record_sequence_{};
+    size_t file_bytes_{};
+    Clock::time_point file_opened_{};
+    Clock::time_point last_flush_{};
+    Clock::time_point last_sync_{};
+    bool dirty_{};
+    std::unique_ptr<uint8_t, void (*)(void*)> buffer_;
+    size_t buffer_capacity_{};
+    size_t buffered_{};
+    std::string session_name_;
+
+    // metrics, written by both sides
+    std::atomic<size_t> queue_depth_{}; // as of the last push
+    std::atomic<size_t> queue_high_water_{};
+    std::atomic<uint64_t> records_queued_{};
+    std::atomic<uint64_t> records_dropped_{};
+    std::atomic<uint64_t> bytes_written_{};
+    std::atomic<uint64_t> writes_{};
+    std::atomic<uint64_t> syncs_{};
+    std::atomic<uint64_t> write_errors_{};
+    std::atomic<uint32_t> last_write_us_{};
+    std::atomic<uint32_t> max_write_us_{};
+    std::atomic<uint32_t> last_sync_us_{};
+    std::atomic<uint32_t> max_sync_us_{};
+    std::atomic<uint32_t> files_opened_{};
+
+    bool push(const Entry& entry);
+    void run();
+    void drain();
+    void append(const Entry& entry);
+    void writeBlocks(bool pad);
+    void sync();
+    bool openFile();
+    void closeFile();
+    void recoverPrevious();
+};
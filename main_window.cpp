@@ -1,24 +1,107 @@
 #include "main_window.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <iostream>
 
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGestureEvent>
 #include <QSwipeGesture>
+#include <QStandardPaths>
+#include <QElapsedTimer>
 
-MainWindow::MainWindow(QWidget* parent)
+#include "startup_trace.h"
+#include "track/track_format.h"
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t unixNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+MainWindow::MainWindow(Options options, QWidget* parent)
     : QMainWindow(parent)
 {
-    buildUi();
+    // connect first so the links come up while the widgets are being built
+    ubx::cfg::ReceiverProfile profile;
+    profile.meas_rate_ms = 100; // 10 Hz
+    // the receivers are F9Ps; their HPPOSLLH residuals refine every position
+    profile.messages.push_back(ubx::cfg::kNavHpposllh);
+    // a moving base / rover pair; only the rover outputs it
+    if (options.receivers.size() > 1)
+        profile.messages.push_back(ubx::cfg::kNavRelposned);
+
+    gnss_ = new GnssHub(std::move(options.receivers), profile, this);
+
+    gnss_->setCorrectionSource(options.rtcm);
 
-    gnss_ = new GnssClient(this);
-    gnss_->connectTcp("192.168.0.151", 8100);
+    // two crc checks on a mapped page; the last fix also aids the receivers
+    restoreState();
+    startup::mark("state restored");
+
+    // a mapping and a header check, no parsing
+    if (!options.poi_index.isEmpty())
+    {
+        auto index = std::make_unique<PoiIndex>(options.poi_index.toStdString());
+        if (index->isOpen())
+            gnss_->setPoiAlerter(std::make_unique<PoiAlerter>(std::move(index)));
+        else
+            std::cout << "poi index " << options.poi_index.toStdString() << " not loaded" << std::endl;
+        startup::mark("poi index mapped");
+    }
+
+    if (!options.road_index.isEmpty())
+    {
+        auto index = std::make_unique<RoadIndex>(options.road_index.toStdString());
+        if (index->isOpen())
+            gnss_->setRoadMatcher(std::make_unique<RoadMatcher>(std::move(index)));
+        else
+            std::cout << "road index " << options.road_index.toStdString() << " not loaded" << std::endl;
+        startup::mark("road index mapped");
+    }
+
+    // kept runs are read on the first epoch, not here
+    PerformanceMeter::Config perf_config;
+    perf_config.store = (QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+                         "/runs.csv").toStdString();
+    gnss_->setPerformanceMeter(std::make_unique<PerformanceMeter>(perf_config));
+
+    shm_publisher_ = std::make_unique<GnssShmPublisher>(GnssShmPublisher::Config{});
+    if (shm_publisher_->open())
+        gnss_->setShmPublisher(shm_publisher_.get());
+    else
+        shm_publisher_.reset();
+
+    gnss_->start();
+    startup::mark("gnss connect issued");
+
+    buildUi();
+    if (state_.page > 0 && state_.page < pages_->count())
+        pages_->setCurrentIndex(state_.page);
+    startup::mark("ui built");
 
     ui_timer_.setInterval(200); // 5 Hz
     connect(&ui_timer_, &QTimer::timeout, this, &MainWindow::onUiTick);
     ui_timer_.start();
+
+    // recovering the previous ride log reads a file, keep it off the path
+    // to the first frame
+    QTimer::singleShot(0, this, &MainWindow::startRideLogger);
 }
 
 void MainWindow::buildUi()
@@ -29,10 +112,12 @@ void MainWindow::buildUi()
     pages_ = new QStackedWidget(root);
 
     speedometer_compass_ = new SpeedometerCompass(pages_);
-    gnss_status_ = new GnssStatus(pages_);
-
     pages_->addWidget(speedometer_compass_);
-    pages_->addWidget(gnss_status_);
+
+    // off-screen pages start as empty placeholders, see onPageChanged
+    pages_->addWidget(new QWidget(pages_));
+    pages_->addWidget(new QWidget(pages_));
+    connect(pages_, &QStackedWidget::currentChanged, this, &MainWindow::onPageChanged);
 
     pages_->grabGesture(Qt::SwipeGesture);
 
@@ -61,27 +146,203 @@ void MainWindow::buildUi()
     outer->addLayout(nav);
 }
 
+void MainWindow::startRideLogger()
+{
+    RideLogger::Config config;
+    config.directory = (QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+                        "/rides").toStdString();
+
+    ride_logger_ = std::make_unique<RideLogger>(config);
+    if (ride_logger_->start())
+        gnss_->setRideLogger(ride_logger_.get());
+    else
+        ride_logger_.reset();
+}
+
+void MainWindow::restoreState()
+{
+    const std::string path = (QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+                              "/state.bin").toStdString();
+    if (!state_file_.open(path))
+    {
+        std::cout << "state file " << path << " not available, nothing is kept across restarts" << std::endl;
+        return;
+    }
+    if (!state_file_.load(state_))
+        state_ = persist::State{};
+
+    const int64_t now_ms = unixNowMs();
+    // a clock behind the last save (no RTC, not synced yet) says nothing
+    // about how long we were off; start a new trip rather than guess
+    if (state_.saved_unix_ms == 0 || now_ms < state_.saved_unix_ms ||
+        now_ms - state_.saved_unix_ms > kTripBreakMs)
+    {
+        state_.trip = persist::Trip{};
+        state_.trip.start_unix_ms = now_ms;
+    }
+    odo_base_m_ = state_.odometer_m;
+    trip_base_m_ = state_.trip.distance_m;
+    odo_distance_ = static_cast<float>(odo_base_m_ / kMetersPerMile);
+
+    ubx::mga::Aiding aiding;
+    if (state_.fix.valid)
+    {
+        aiding.have_position = true;
+        aiding.lat = state_.fix.lat;
+        aiding.lon = state_.fix.lon;
+        aiding.height = state_.fix.height;
+        aiding.position_acc_mm = std::max(state_.fix.horizontal_acc_mm, kMinAidingAccMm);
+    }
+    aiding.have_time = ubx::mga::systemClockSynchronized(aiding.time_acc_ms);
+    gnss_->setAiding(aiding);
+}
+
+void MainWindow::updateState(const GnssHub::Snapshot& snapshot)
+{
+    const int64_t now_ns = steadyNowNs();
+    const double dt_s = last_tick_ns_ == 0 ? 0.0 : (now_ns - last_tick_ns_) * 1e-9;
+    last_tick_ns_ = now_ns;
+
+    // the merger's odometer starts from zero every run
+    const double run_m = snapshot.merged.odometer_m;
+    state_.odometer_m = odo_base_m_ + run_m;
+    state_.trip.distance_m = trip_base_m_ + run_m;
+
+    const UbxNavPvtMsg& pvt = snapshot.merged.nav_pvt;
+    if (snapshot.merged.valid && pvt.flags.gnss_fix_ok && pvt.fix_type >= 2U)
+    {
+        const GnssPvt& s = snapshot.merged.pvt;
+        if (s.velocity_2d > 1.0f)
+            state_.trip.moving_s += dt_s;
+        state_.trip.max_mph = std::max(state_.trip.max_mph, s.sog_mph);
+
+        state_.fix.valid = 1U;
+        state_.fix.lat = pvt.lat.value();
+        state_.fix.lon = pvt.lon.value();
+        state_.fix.height = pvt.height.value();
+        state_.fix.horizontal_acc_mm = pvt.horizontal_acc.value();
+        state_.fix.unix_ms = track::fromNavPvt(pvt).time_ms;
+        state_.fix.heading = s.heading;
+    }
+
+    if (now_ns - last_save_ns_ >= kStateSaveIntervalNs)
+        saveState();
+}
+
+void MainWindow::saveState()
+{
+    if (!state_file_.isOpen())
+        return;
+
+    last_save_ns_ = steadyNowNs();
+    state_.page = pages_ ? pages_->currentIndex() : 0;
+    state_.saved_unix_ms = unixNowMs();
+    state_file_.save(state_);
+}
+
 void MainWindow::onUiTick()
 {
     if (gnss_ == nullptr)
         return;
 
-    if (!gnss_->isConnected())
+    QElapsedTimer cost;
+    cost.start();
+
+    if (ride_logger_ && gnss_status_)
+        gnss_status_->setLoggerMetrics(ride_logger_->metrics());
+
+    // one copy per tick, however many receivers there are
+    const GnssHub::Snapshot snapshot = gnss_->snapshot();
+
+    if (gnss_status_)
+    {
+        gnss_status_->setConfigStatus(snapshot.receivers);
+        gnss_status_->setMergeStatus(snapshot.merged);
+        gnss_status_->setGovernorStatus(QString::fromStdString(governor_.describe()));
+        gnss_status_->setPerformanceStatus(snapshot.perf);
+        gnss_status_->setCorrectionStatus(snapshot.rtcm_status);
+    }
+
+    updateState(snapshot);
+    if (gnss_status_)
+        gnss_status_->setTripStatus(state_.trip);
+
+    if (!snapshot.anyConnected())
     {
+        // what was last known, until the receiver is back
         if (speedometer_compass_) speedometer_compass_->setDisconnected();
+        if (speedometer_compass_ && state_.fix.valid)
+            speedometer_compass_->setLastKnown(static_cast<float>(state_.odometer_m / kMetersPerMile), state_.fix.heading);
         if (gnss_status_) gnss_status_->setDisconnected();
+        governor_.recordUpdate(std::chrono::nanoseconds(cost.nsecsElapsed()));
+        updateGovernor(0.0f);
         return;
     }
 
-    const GnssPvt& s = gnss_->state();
+    const GnssPvt& s = snapshot.merged.pvt;
+
+    if (!first_epoch_marked_ && s.gps_tow_ms != 0U)
+    {
+        first_epoch_marked_ = true;
+        startup::mark("first epoch on ui tick");
+    }
+
+    odo_distance_ = static_cast<float>(state_.odometer_m / kMetersPerMile);
 
     if (speedometer_compass_)
+    {
         speedometer_compass_->updateFromGnss(s, odo_distance_);
+        speedometer_compass_->setAlert(snapshot.poi_alert);
+        speedometer_compass_->setRoad(snapshot.road);
+    }
 
     if (gnss_status_)
         gnss_status_->updateFromGnss(s);
 
-   
+    // fed on the I/O thread; only the visible window is fetched
+    if (history_chart_ && pages_->currentWidget() == history_chart_)
+        history_chart_->refresh();
+
+    governor_.recordUpdate(std::chrono::nanoseconds(cost.nsecsElapsed()));
+    updateGovernor(s.velocity_2d);
+}
+
+void MainWindow::updateGovernor(float speed_mps)
+{
+    governor_.setSpeed(speed_mps, std::chrono::steady_clock::now());
+
+    // sysfs reads are cheap but not free; the temperature moves slowly
+    if (governor_ticks_++ % 25 == 0)
+        governor_.setTemperature(readSocTemperature());
+
+    if (!governor_.evaluate())
+        return;
+
+    ui_timer_.setInterval(governor_.intervalMs());
+    if (speedometer_compass_)
+        speedometer_compass_->setDetail(governor_.detail());
+}
+
+void MainWindow::onPageChanged(int index)
+{
+    // every change, not only the first visit to a lazy page
+    saveState();
+
+    QWidget* page = nullptr;
+    if (index == kGnssStatusPage && !gnss_status_)
+        page = gnss_status_ = new GnssStatus(pages_);
+    else if (index == kHistoryPage && !history_chart_)
+        page = history_chart_ = new HistoryChart(gnss_, pages_);
+    if (!page)
+        return;
+
+    QWidget* placeholder = pages_->widget(index);
+    pages_->insertWidget(index, page);
+    pages_->setCurrentIndex(index);
+    pages_->removeWidget(placeholder);
+    placeholder->deleteLater();
+
+    onUiTick();
 }
 
 void MainWindow::showPrevPage()
@@ -102,6 +363,17 @@ void MainWindow::showNextPage()
 
 bool MainWindow::event(QEvent* e)
 {
+    // the backing store repaints every dirty widget while handling this, so
+    // its duration is the paint cost of the frame
+    if (e->type() == QEvent::UpdateRequest)
+    {
+        QElapsedTimer paint;
+        paint.start();
+        const bool handled = QMainWindow::event(e);
+        governor_.recordPaint(std::chrono::nanoseconds(paint.nsecsElapsed()));
+        return handled;
+    }
+
     if (e->type() == QEvent::Gesture)
     {
         auto* ge = static_cast<QGestureEvent*>(e);
@@ -121,7 +393,21 @@ bool MainWindow::event(QEvent* e)
     return QMainWindow::event(e);
 }
 
+MainWindow::~MainWindow()
+{
+    // the hub's I/O thread writes to the logger and the shared memory; as a
+    // child it would only go in ~QObject, after those are freed
+    delete gnss_;
+    gnss_ = nullptr;
+}
+
 void MainWindow::exitApplication() {
 
+    // std::exit skips destructors, so get the ride log onto the card first
+    if (ride_logger_)
+        ride_logger_->stop();
+    saveState();
+    state_file_.sync();
+
     std::exit(EXIT_SUCCESS);
 }
\ No newline at end of file
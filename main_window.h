@@ -1,20 +1,37 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include <QMainWindow>
 #include <QStackedWidget>
 #include <QPushButton>
 #include <QTimer>
 
-#include "devices/gnss_client.h"
+#include "core/persistent_state.h"
+#include "devices/gnss_hub.h"
+#include "frame_governor.h"
+#include "ipc/gnss_shm.h"
+#include "logging/ride_logger.h"
 #include "widgets/speedometer_compass.h"
 #include "widgets/gnss_status.h"
+#include "widgets/history_chart.h"
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    explicit MainWindow(QWidget* parent = nullptr);
+    struct Options {
+        // the first receiver is the primary and feeds the ride log
+        std::vector<GnssHub::Endpoint> receivers;
+        QString poi_index;  // .mpoi file, empty for none
+        QString road_index; // .mroad file, empty for none
+        RtcmRelay::Config rtcm; // corrections for the first receiver, no host for none
+    };
+
+    explicit MainWindow(Options options, QWidget* parent = nullptr);
+    ~MainWindow() override;
 
 protected:
     bool event(QEvent* e) override;
@@ -23,12 +40,27 @@ private slots:
     void onUiTick();
     void showPrevPage();
     void showNextPage();
+    void onPageChanged(int index);
 
 private:
     void buildUi();
+    void startRideLogger();
+    void restoreState();
+    void updateState(const GnssHub::Snapshot& snapshot);
+    void saveState();
+    void updateGovernor(float speed_mps);
     void exitApplication();
 
 private:
+    static constexpr int kGnssStatusPage = 1;
+    static constexpr int kHistoryPage = 2;
+    static constexpr double kMetersPerMile = 1609.344;
+    // a restart within this of the last save continues the trip
+    static constexpr int64_t kTripBreakMs = 30LL * 60 * 1000;
+    static constexpr int64_t kStateSaveIntervalNs = 5'000'000'000LL;
+    // the receiver may have been carried while off; it only narrows the search
+    static constexpr uint32_t kMinAidingAccMm = 1'000'000U;
+
     QStackedWidget* pages_ = nullptr;
     QPushButton* prev_btn_ = nullptr;
     QPushButton* next_btn_ = nullptr;
@@ -36,10 +68,23 @@ private:
 
     SpeedometerCompass* speedometer_compass_ = nullptr;
     GnssStatus* gnss_status_ = nullptr;
+    HistoryChart* history_chart_ = nullptr;
 
-    GnssClient* gnss_ = nullptr;
+    GnssHub* gnss_ = nullptr;
+    std::unique_ptr<RideLogger> ride_logger_;
+    std::unique_ptr<GnssShmPublisher> shm_publisher_;
     QTimer ui_timer_;
+    FrameGovernor governor_;
+    int governor_ticks_ = 0;
+
+    PersistentState state_file_;
+    persist::State state_{};
+    double odo_base_m_ = 0.0;  // total before this run
+    double trip_base_m_ = 0.0; // of the trip before this run
+    int64_t last_tick_ns_ = 0;
+    int64_t last_save_ns_ = 0;
 
     float odo_distance_ = 0.0f;
+    bool first_epoch_marked_ = false;
     float fake_speed_val_ = 0.0f;
 };
\ No newline at end of file
@@ -29,16 +29,73 @@
 // }
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <iostream>
 #include "main_window.h"
+#include "startup_trace.h"
 
 int main(int argc, char** argv)
 {
+    startup::mark("main");
     QApplication app(argc, argv);
+    startup::mark("application created");
 
-    MainWindow w;
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption host("host", "Receiver address.", "host", "192.168.0.151");
+    const QCommandLineOption port("port", "Receiver TCP port.", "port", "8100");
+    const QCommandLineOption receiver("receiver", "Additional receiver, repeatable.", "host:port");
+    const QCommandLineOption poi("poi", "Point of interest index (.mpoi) to alert on.", "file");
+    const QCommandLineOption roads("roads", "Road index (.mroad) for road name and speed limit.", "file");
+    const QCommandLineOption rtcm("rtcm", "RTCM 3 caster for the first receiver; NTRIP with a mountpoint.",
+                                  "host:port[/mountpoint]");
+    const QCommandLineOption rtcm_user("rtcm-user", "NTRIP credentials.", "user:password");
+    parser.addOptions({host, port, receiver, poi, roads, rtcm, rtcm_user});
+    parser.process(app);
+
+    MainWindow::Options options;
+    options.poi_index = parser.value(poi);
+    options.road_index = parser.value(roads);
+
+    std::vector<GnssHub::Endpoint>& receivers = options.receivers;
+    receivers.push_back({parser.value(host), static_cast<quint16>(parser.value(port).toUInt())});
+    for (const QString& extra : parser.values(receiver))
+    {
+        const int colon = extra.lastIndexOf(':');
+        if (colon <= 0)
+        {
+            std::cout << "ignoring receiver '" << extra.toStdString() << "', expected host:port" << std::endl;
+            continue;
+        }
+        receivers.push_back({extra.left(colon), static_cast<quint16>(extra.mid(colon + 1).toUInt())});
+    }
+
+    if (parser.isSet(rtcm))
+    {
+        QString caster = parser.value(rtcm);
+        const int slash = caster.indexOf('/');
+        if (slash >= 0)
+        {
+            options.rtcm.mountpoint = caster.mid(slash + 1);
+            caster.truncate(slash);
+        }
+        const int colon = caster.lastIndexOf(':');
+        options.rtcm.host = colon > 0 ? caster.left(colon) : caster;
+        if (colon > 0)
+            options.rtcm.port = static_cast<quint16>(caster.mid(colon + 1).toUInt());
+
+        const QString credentials = parser.value(rtcm_user);
+        const int separator = credentials.indexOf(':');
+        options.rtcm.user = separator >= 0 ? credentials.left(separator) : credentials;
+        if (separator >= 0)
+            options.rtcm.password = credentials.mid(separator + 1);
+    }
+
+    MainWindow w(std::move(options));
     // w.showFullScreen();   
     w.resize(800,480);
     w.show();
+    startup::mark("window shown");
 
     return app.exec();
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "poi_alerter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/geodesy.h"
+
+PoiAlerter::PoiAlerter(std::unique_ptr<PoiIndex> index)
+    : PoiAlerter(std::move(index), Config{})
+{
+}
+
+PoiAlerter::PoiAlerter(std::unique_ptr<PoiIndex> index, Config config)
+    : index_(std::move(index))
+    , config_(config)
+{
+}
+
+const poi::Alert& PoiAlerter::update(const GnssPvt& pvt, int64_t now_ms)
+{
+    const bool moving = pvt.velocity_2d >= config_.min_heading_speed_mps;
+
+    PoiIndex::Cone cone;
+    cone.lat = pvt.position.lat;
+    cone.lon = pvt.position.lon;
+    cone.heading_deg = pvt.heading;
+    cone.half_angle_deg = config_.half_angle_deg;
+    cone.range_m = moving ? std::clamp(pvt.velocity_2d * config_.lookahead_s, config_.min_range_m,
+                                       config_.max_range_m)
+                          : 0.0f;
+    cone.near_m = config_.near_m;
+    cone.category_mask = config_.category_mask;
+
+    PoiIndex::Hit hits[kMaxHits];
+    const size_t count = index_->query(cone, hits, kMaxHits);
+
+    // stay on the current point while it is still a hit, so two stations
+    // across the road do not take turns
+    const PoiIndex::Hit* chosen = count > 0U ? &hits[0] : nullptr;
+    for (size_t i = 0; alert_.active && i < count; ++i) {
+        if (hits[i].poi == alert_.poi)
+            chosen = &hits[i];
+    }
+
+    if (chosen) {
+        show(*chosen, pvt.heading);
+        last_seen_ms_ = now_ms;
+        return alert_;
+    }
+
+    if (alert_.active && now_ms - last_seen_ms_ <= config_.hold_ms) {
+        const poi::Poi& p = index_->at(alert_.poi);
+        alert_.distance_m = static_cast<float>(
+            geodesy::horizontalDistance(pvt.position, GeoPoint{p.lat, p.lon}));
+        return alert_;
+    }
+
+    alert_ = poi::Alert{};
+    return alert_;
+}
+
+void PoiAlerter::show(const PoiIndex::Hit& hit, float heading_deg)
+{
+    if (!alert_.active || alert_.poi != hit.poi) {
+        const poi::Poi& p = index_->at(hit.poi);
+        alert_.active = true;
+        alert_.poi = hit.poi;
+        alert_.category = std::string(index_->categoryName(p.category));
+        alert_.name = std::string(index_->name(hit.poi));
+    }
+    alert_.distance_m = hit.distance_m;
+    alert_.relative_bearing_deg = std::remainder(hit.bearing_deg - heading_deg, 360.0f);
+}
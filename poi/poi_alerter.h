@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "core/gnss_pvt.h"
+#include "poi_index.h"
+
+namespace poi {
+
+struct Alert {
+    bool active{};
+    uint32_t poi{};
+    std::string category;
+    std::string name;
+    float distance_m{};
+    float relative_bearing_deg{}; // -180..180, 0 is dead ahead
+};
+
+} // namespace poi
+
+// Turns per-epoch cone queries into a steady alert: the cone reaches
+// further ahead the faster the bike goes, an alert sticks to its point
+// while that point stays in the cone, and it is held for a moment after
+// the point drops out so the tile does not flicker.
+class PoiAlerter {
+    public:
+    struct Config {
+        float lookahead_s{30.0f};
+        float min_range_m{300.0f};
+        float max_range_m{2000.0f};
+        float half_angle_deg{25.0f};
+        float near_m{60.0f};               // alert regardless of heading
+        float min_heading_speed_mps{2.0f}; // slower: heading unreliable, near circle only
+        int64_t hold_ms{3000};
+        uint32_t category_mask{UINT32_MAX};
+    };
+
+    explicit PoiAlerter(std::unique_ptr<PoiIndex> index);
+    PoiAlerter(std::unique_ptr<PoiIndex> index, Config config);
+
+    // once per epoch
+    const poi::Alert& update(const GnssPvt& pvt, int64_t now_ms);
+    const poi::Alert& alert() const { return alert_; }
+
+    const PoiIndex& index() const { return *index_; }
+
+    private:
+    static constexpr size_t kMaxHits{4U};
+
+    std::unique_ptr<PoiIndex> index_;
+    Config config_;
+    poi::Alert alert_;
+    int64_t last_seen_ms_{};
+
+    void show(const PoiIndex::Hit& hit, float heading_deg);
+};
@@ -0,0 +1,118 @@
+#include "poi_builder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace {
+
+constexpr int32_t kMaxLatE7{900000000};
+constexpr int32_t kMaxLonE7{1800000000};
+
+bool writeBytes(std::ofstream& out, const void* data, size_t length)
+{
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    return out.good();
+}
+
+} // namespace
+
+PoiBuilder::PoiBuilder(int32_t cell_e7)
+    : cell_e7_(std::max(cell_e7, geo_grid::kMinCellE7))
+{
+}
+
+bool PoiBuilder::add(int32_t lat, int32_t lon, const std::string& category, const std::string& name)
+{
+    if (lat < -kMaxLatE7 || lat > kMaxLatE7 || lon < -kMaxLonE7 || lon > kMaxLonE7)
+        return false;
+
+    auto it = std::find(categories_.begin(), categories_.end(), category);
+    if (it == categories_.end()) {
+        if (categories_.size() == poi::kMaxCategories)
+            return false;
+        categories_.push_back(category.substr(0, poi::kCategoryNameSize - 1U));
+        it = categories_.end() - 1;
+    }
+
+    const auto [name_it, inserted] = name_offsets_.try_emplace(name, static_cast<uint32_t>(names_.size()));
+    if (inserted) {
+        names_.append(name);
+        names_.push_back('\0');
+    }
+
+    Entry entry{};
+    entry.key = geo_grid::key(geo_grid::row(lat, cell_e7_), geo_grid::column(lon, cell_e7_), cell_e7_);
+    entry.poi.lat = lat;
+    entry.poi.lon = lon;
+    entry.poi.category = static_cast<uint16_t>(it - categories_.begin());
+    entry.poi.name = name_it->second;
+    entries_.push_back(entry);
+    return true;
+}
+
+bool PoiBuilder::write(const std::filesystem::path& path)
+{
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+        if (a.key != b.key)
+            return a.key < b.key;
+        return a.poi.lat != b.poi.lat ? a.poi.lat < b.poi.lat : a.poi.lon < b.poi.lon;
+    });
+
+    std::vector<poi::Cell> cells;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (cells.empty() || cells.back().key != entries_[i].key)
+            cells.push_back({entries_[i].key, static_cast<uint32_t>(i)});
+    }
+    const uint32_t cell_count = static_cast<uint32_t>(cells.size());
+    cells.push_back({UINT32_MAX, static_cast<uint32_t>(entries_.size())});
+
+    std::vector<poi::Category> categories(categories_.size());
+    for (size_t i = 0; i < categories_.size(); ++i)
+        std::strncpy(categories[i].name, categories_[i].c_str(), poi::kCategoryNameSize - 1U);
+
+    poi::FileHeader header{};
+    header.magic = poi::kFileMagic;
+    header.version = poi::kFormatVersion;
+    header.category_count = static_cast<uint16_t>(categories.size());
+    header.cell_e7 = cell_e7_;
+    header.cell_count = cell_count;
+    header.poi_count = static_cast<uint32_t>(entries_.size());
+    header.names_size = static_cast<uint32_t>(names_.size());
+
+    // every record size is a multiple of 8, so the sections stay aligned
+    uint64_t offset = sizeof(header);
+    header.categories_offset = offset;
+    offset += categories.size() * sizeof(poi::Category);
+    header.cells_offset = offset;
+    offset += cells.size() * sizeof(poi::Cell);
+    header.pois_offset = offset;
+    offset += entries_.size() * sizeof(poi::Poi);
+    header.names_offset = offset;
+    header.header_crc = poi::fileHeaderCrc(header);
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    bool ok = writeBytes(out, &header, sizeof(header));
+    ok = ok && writeBytes(out, categories.data(), categories.size() * sizeof(poi::Category));
+    ok = ok && writeBytes(out, cells.data(), cells.size() * sizeof(poi::Cell));
+    for (const Entry& entry : entries_)
+        ok = ok && writeBytes(out, &entry.poi, sizeof(entry.poi));
+    ok = ok && writeBytes(out, names_.data(), names_.size());
+    out.close();
+
+    std::error_code ec;
+    if (ok)
+        std::filesystem::rename(temporary, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "poi_format.h"
+
+// Collects points in any order and writes them as a .mpoi index. Runs
+// offline (motohud-poi build); the whole data set is held in memory.
+class PoiBuilder {
+    public:
+    explicit PoiBuilder(int32_t cell_e7 = poi::kDefaultCellE7);
+
+    // false if the category table is full or the position is out of range
+    bool add(int32_t lat, int32_t lon, const std::string& category, const std::string& name);
+
+    // writes to a temporary file and renames it over `path`, so a HUD
+    // mapping the old index never sees a half written one
+    bool write(const std::filesystem::path& path);
+
+    size_t size() const { return entries_.size(); }
+    size_t categoryCount() const { return categories_.size(); }
+    int32_t cellE7() const { return cell_e7_; }
+
+    private:
+    struct Entry {
+        uint32_t key;
+        poi::Poi poi;
+    };
+
+    int32_t cell_e7_;
+    std::vector<Entry> entries_;
+    std::vector<std::string> categories_;
+    std::string names_;
+    std::unordered_map<std::string, uint32_t> name_offsets_; // repeated brand names stored once
+};
@@ -0,0 +1,14 @@
+#include "poi_format.h"
+
+#include <boost/crc.hpp>
+
+namespace poi {
+
+uint32_t fileHeaderCrc(const FileHeader& header)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(&header, offsetof(FileHeader, header_crc));
+    return crc.checksum();
+}
+
+} // namespace poi
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/geo_grid.h"
+
+// On-disk layout of a point of interest index (.mpoi), built offline by
+// motohud-poi and memory mapped read-only by the HUD.
+//
+// Points are bucketed into the geo_grid of cell_e7 x cell_e7 cells (1e-7
+// degree units, like every position in the HUD). Only non-empty cells
+// are stored, as Cell entries sorted by key, followed by one sentinel. The
+// points of a cell are contiguous in the Poi array, from its `first` to the
+// next cell's `first`. One row of the grid is a contiguous key range, so a
+// query costs one binary search per grid row it touches.
+//
+//   FileHeader | Category[category_count] | Cell[cell_count + 1] |
+//   Poi[poi_count] | names (NUL terminated, referenced by offset)
+//
+// Sections are 8 byte aligned. Nothing needs decoding or fixing up at load.
+
+namespace poi {
+
+static constexpr uint32_t kFileMagic{0x494F504DU}; // "MPOI"
+static constexpr uint16_t kFormatVersion{1U};
+static constexpr const char* kFileExtension{".mpoi"};
+
+static constexpr int32_t kDefaultCellE7{100000};  // 0.01 deg, ~1.1 km of latitude
+static constexpr size_t kMaxCategories{32U};      // bit per category in query masks
+static constexpr size_t kCategoryNameSize{16U};
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t category_count;
+    int32_t cell_e7;
+    uint32_t cell_count;   // without the sentinel
+    uint32_t poi_count;
+    uint32_t names_size;
+    uint64_t categories_offset;
+    uint64_t cells_offset;
+    uint64_t pois_offset;
+    uint64_t names_offset;
+    uint32_t reserved;
+    uint32_t header_crc; // crc32 of the preceding fields
+};
+
+struct Category {
+    char name[kCategoryNameSize]; // NUL padded
+};
+
+struct Cell {
+    uint32_t key;
+    uint32_t first; // index of the cell's first Poi
+};
+
+struct Poi {
+    int32_t lat;       // 1e-7 degrees
+    int32_t lon;       // 1e-7 degrees
+    uint16_t category;
+    uint16_t reserved;
+    uint32_t name;     // offset into the names section
+};
+
+static_assert(sizeof(FileHeader) == 64, "poi header layout changed");
+static_assert(sizeof(Poi) == 16, "poi record layout changed");
+
+uint32_t fileHeaderCrc(const FileHeader& header);
+
+} // namespace poi
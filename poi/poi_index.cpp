@@ -0,0 +1,176 @@
+#include "poi_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/geodesy.h"
+
+namespace {
+
+constexpr double kDegToRad{M_PI / 180.0};
+// the cone is a few km at most, so a local flat approximation is well
+// inside the position error
+constexpr double kMetersPerE7{geodesy::kMetersPerE7};
+
+} // namespace
+
+PoiIndex::PoiIndex(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(poi::FileHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return;
+
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+    std::memcpy(&header_, data_, sizeof(header_));
+
+    if (!validate()) {
+        ::munmap(map, size_);
+        data_ = nullptr;
+        size_ = 0U;
+        return;
+    }
+
+    categories_ = reinterpret_cast<const poi::Category*>(data_ + header_.categories_offset);
+    cells_ = reinterpret_cast<const poi::Cell*>(data_ + header_.cells_offset);
+    pois_ = reinterpret_cast<const poi::Poi*>(data_ + header_.pois_offset);
+    names_ = reinterpret_cast<const char*>(data_ + header_.names_offset);
+}
+
+PoiIndex::~PoiIndex()
+{
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+bool PoiIndex::validate() const
+{
+    const poi::FileHeader& h = header_;
+    if (h.magic != poi::kFileMagic || h.version != poi::kFormatVersion ||
+        h.header_crc != poi::fileHeaderCrc(h) || h.cell_e7 < geo_grid::kMinCellE7 ||
+        h.category_count > poi::kMaxCategories)
+        return false;
+
+    const auto fits = [this](uint64_t offset, uint64_t length) {
+        return offset % 8U == 0U && offset <= size_ && length <= size_ - offset;
+    };
+    if (!fits(h.categories_offset, uint64_t{h.category_count} * sizeof(poi::Category)) ||
+        !fits(h.cells_offset, (uint64_t{h.cell_count} + 1U) * sizeof(poi::Cell)) ||
+        !fits(h.pois_offset, uint64_t{h.poi_count} * sizeof(poi::Poi)) || !fits(h.names_offset, h.names_size))
+        return false;
+
+    // the header crc says nothing about the sections; the sentinel at
+    // least has to close the point array, the rest is bounded in query()
+    poi::Cell sentinel;
+    std::memcpy(&sentinel, data_ + h.cells_offset + uint64_t{h.cell_count} * sizeof(poi::Cell), sizeof(sentinel));
+    return sentinel.first == h.poi_count;
+}
+
+int PoiIndex::category(std::string_view name) const
+{
+    for (uint16_t i = 0; i < categoryCount(); ++i) {
+        if (categoryName(i) == name)
+            return i;
+    }
+    return -1;
+}
+
+std::string_view PoiIndex::categoryName(uint16_t category) const
+{
+    if (category >= categoryCount())
+        return {};
+    const char* name = categories_[category].name;
+    return {name, ::strnlen(name, poi::kCategoryNameSize)};
+}
+
+std::string_view PoiIndex::name(uint32_t poi) const
+{
+    const uint32_t offset = pois_[poi].name;
+    if (offset >= header_.names_size)
+        return {};
+    return {names_ + offset, ::strnlen(names_ + offset, header_.names_size - offset)};
+}
+
+size_t PoiIndex::query(const Cone& cone, Hit* hits, size_t max_hits) const
+{
+    if (!isOpen() || max_hits == 0U || header_.cell_count == 0U)
+        return 0U;
+
+    const double cos_lat = std::max(std::cos(cone.lat * 1e-7 * kDegToRad), 0.01);
+    const double reach = std::max(cone.range_m, cone.near_m);
+    const int64_t dlat = static_cast<int64_t>(reach / kMetersPerE7) + 1;
+    const int64_t dlon = static_cast<int64_t>(reach / (kMetersPerE7 * cos_lat)) + 1;
+
+    // no wrap at the antimeridian; nothing rides there
+    const uint32_t row_min = geo_grid::row(geo_grid::clampLat(int64_t{cone.lat} - dlat), header_.cell_e7);
+    const uint32_t row_max = geo_grid::row(geo_grid::clampLat(int64_t{cone.lat} + dlat), header_.cell_e7);
+    const uint32_t col_min = geo_grid::column(geo_grid::clampLon(int64_t{cone.lon} - dlon), header_.cell_e7);
+    const uint32_t col_max = geo_grid::column(geo_grid::clampLon(int64_t{cone.lon} + dlon), header_.cell_e7);
+
+    const double reach2 = reach * reach;
+    const poi::Cell* cells_end = cells_ + header_.cell_count;
+    size_t count = 0U;
+
+    for (uint32_t row = row_min; row <= row_max; ++row) {
+        // a row's cells are one contiguous key range
+        const uint32_t key_min = geo_grid::key(row, col_min, header_.cell_e7);
+        const uint32_t key_max = geo_grid::key(row, col_max, header_.cell_e7);
+        const poi::Cell* cell = std::lower_bound(cells_, cells_end, key_min,
+                                                 [](const poi::Cell& c, uint32_t key) { return c.key < key; });
+
+        for (; cell != cells_end && cell->key <= key_max; ++cell) {
+            // a damaged entry must not reach past the points
+            const uint32_t end = std::min((cell + 1)->first, header_.poi_count);
+            for (uint32_t i = cell->first; i < end; ++i) {
+                const poi::Poi& p = pois_[i];
+                if (p.category >= poi::kMaxCategories || !(cone.category_mask & (1U << p.category)))
+                    continue;
+
+                const double north = (static_cast<int64_t>(p.lat) - cone.lat) * kMetersPerE7;
+                const double east = (static_cast<int64_t>(p.lon) - cone.lon) * kMetersPerE7 * cos_lat;
+                const double d2 = north * north + east * east;
+                if (d2 > reach2)
+                    continue;
+
+                const float distance = static_cast<float>(std::sqrt(d2));
+                float bearing = static_cast<float>(std::atan2(east, north) / kDegToRad);
+                if (bearing < 0.0f)
+                    bearing += 360.0f;
+
+                if (distance > cone.near_m) {
+                    if (distance > cone.range_m)
+                        continue;
+                    const float off = std::fabs(std::remainder(bearing - cone.heading_deg, 360.0f));
+                    if (off > cone.half_angle_deg)
+                        continue;
+                }
+
+                // insertion into the short nearest-first list
+                if (count == max_hits && distance >= hits[count - 1].distance_m)
+                    continue;
+                size_t j = count < max_hits ? count++ : count - 1;
+                for (; j > 0 && hits[j - 1].distance_m > distance; --j)
+                    hits[j] = hits[j - 1];
+                hits[j] = Hit{i, distance, bearing};
+            }
+        }
+    }
+    return count;
+}
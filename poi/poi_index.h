@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "poi_format.h"
+
+// Memory mapped, read-only view of a .mpoi index. Opening validates the
+// header, section bounds and the cell sentinel only, so it takes the same
+// time for ten points or a million; pages fault in as queries touch them,
+// and cell entries are bounded where they are used.
+class PoiIndex {
+    public:
+    // a look-ahead cone: points within range_m whose bearing is within
+    // half_angle_deg of heading_deg, plus anything closer than near_m
+    struct Cone {
+        int32_t lat{};          // 1e-7 degrees
+        int32_t lon{};          // 1e-7 degrees
+        float heading_deg{};
+        float half_angle_deg{30.0f};
+        float range_m{500.0f};
+        float near_m{0.0f};
+        uint32_t category_mask{UINT32_MAX}; // bit per category id
+    };
+
+    struct Hit {
+        uint32_t poi;         // index for name() and category()
+        float distance_m;
+        float bearing_deg;    // absolute, from the query position
+    };
+
+    explicit PoiIndex(const std::filesystem::path& path);
+    ~PoiIndex();
+
+    PoiIndex(const PoiIndex&) = delete;
+    PoiIndex& operator=(const PoiIndex&) = delete;
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t size() const { return isOpen() ? header_.poi_count : 0U; }
+    size_t cellCount() const { return isOpen() ? header_.cell_count : 0U; }
+    size_t categoryCount() const { return isOpen() ? header_.category_count : 0U; }
+    int32_t cellE7() const { return header_.cell_e7; }
+    size_t mappedBytes() const { return size_; }
+
+    // id of a category by name, or -1
+    int category(std::string_view name) const;
+    std::string_view categoryName(uint16_t category) const;
+
+    const poi::Poi& at(uint32_t poi) const { return pois_[poi]; }
+    std::string_view name(uint32_t poi) const;
+
+    // up to max_hits points in the cone, nearest first; returns the count
+    size_t query(const Cone& cone, Hit* hits, size_t max_hits) const;
+
+    private:
+    const uint8_t* data_{};
+    size_t size_{};
+    poi::FileHeader header_{};
+    const poi::Category* categories_{};
+    const poi::Cell* cells_{};
+    const poi::Poi* pois_{};
+    const char* names_{};
+
+    bool validate() const;
+};
@@ -0,0 +1,189 @@
+#include "road_builder.h"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+
+namespace {
+
+bool writeBytes(std::ofstream& out, const void* data, size_t length)
+{
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    return out.good();
+}
+
+uint64_t alignUp(uint64_t offset)
+{
+    return (offset + 7U) & ~uint64_t{7U};
+}
+
+uint64_t coordinateKey(const road::Point& p)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(p.lat)) << 32) | static_cast<uint32_t>(p.lon);
+}
+
+} // namespace
+
+RoadBuilder::RoadBuilder(int32_t cell_e7)
+    : cell_e7_(std::max(cell_e7, geo_grid::kMinCellE7))
+{
+}
+
+bool RoadBuilder::add(const std::string& name, uint8_t max_speed, uint8_t flags,
+                      const std::vector<road::Point>& points)
+{
+    if (points.size() < 2U)
+        return false;
+
+    const auto [name_it, inserted] = name_offsets_.try_emplace(name, static_cast<uint32_t>(names_.size()));
+    if (inserted) {
+        names_.append(name);
+        names_.push_back('\0');
+    }
+
+    road::Way way{};
+    way.first_point = static_cast<uint32_t>(points_.size());
+    way.point_count = static_cast<uint32_t>(points.size());
+    way.name = name_it->second;
+    way.max_speed = max_speed;
+    way.flags = flags;
+
+    points_.insert(points_.end(), points.begin(), points.end());
+    point_way_.insert(point_way_.end(), points.size(), static_cast<uint32_t>(ways_.size()));
+    ways_.push_back(way);
+    return true;
+}
+
+void RoadBuilder::buildLinks(std::vector<uint32_t>& link_first, std::vector<uint32_t>& links) const
+{
+    // points sharing a coordinate are the same OSM node
+    std::unordered_map<uint64_t, std::vector<uint32_t>> nodes;
+    nodes.reserve(points_.size());
+    for (uint32_t p = 0; p < points_.size(); ++p)
+        nodes[coordinateKey(points_[p])].push_back(p);
+
+    link_first.assign(points_.size() + 1U, 0U);
+    for (uint32_t p = 0; p < points_.size(); ++p) {
+        link_first[p] = static_cast<uint32_t>(links.size());
+        const std::vector<uint32_t>& same = nodes[coordinateKey(points_[p])];
+        if (same.size() < 2U)
+            continue;
+
+        for (const uint32_t q : same) {
+            const uint32_t way = point_way_[q];
+            if (way == point_way_[p])
+                continue;
+            const road::Way& w = ways_[way];
+            // the other way's segments ending and starting at this node
+            if (q > w.first_point)
+                links.push_back(q - 1U);
+            if (q + 1U < w.first_point + w.point_count)
+                links.push_back(q);
+        }
+    }
+    link_first[points_.size()] = static_cast<uint32_t>(links.size());
+}
+
+void RoadBuilder::buildGrid(std::vector<road::Cell>& cells, std::vector<uint32_t>& buckets) const
+{
+    std::vector<std::pair<uint32_t, uint32_t>> entries; // key, segment
+    entries.reserve(points_.size());
+
+    for (const road::Way& w : ways_) {
+        for (uint32_t s = w.first_point; s + 1U < w.first_point + w.point_count; ++s) {
+            const road::Point& a = points_[s];
+            const road::Point& b = points_[s + 1U];
+            // every cell the segment's bounding box touches
+            const uint32_t row_min = geo_grid::row(std::min(a.lat, b.lat), cell_e7_);
+            const uint32_t row_max = geo_grid::row(std::max(a.lat, b.lat), cell_e7_);
+            const uint32_t col_min = geo_grid::column(std::min(a.lon, b.lon), cell_e7_);
+            const uint32_t col_max = geo_grid::column(std::max(a.lon, b.lon), cell_e7_);
+            for (uint32_t row = row_min; row <= row_max; ++row) {
+                for (uint32_t col = col_min; col <= col_max; ++col)
+                    entries.emplace_back(geo_grid::key(row, col, cell_e7_), s);
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    buckets.reserve(entries.size());
+    for (const auto& [key, segment] : entries) {
+        if (cells.empty() || cells.back().key != key)
+            cells.push_back({key, static_cast<uint32_t>(buckets.size())});
+        buckets.push_back(segment);
+    }
+}
+
+bool RoadBuilder::write(const std::filesystem::path& path)
+{
+    std::vector<uint32_t> link_first;
+    std::vector<uint32_t> links;
+    buildLinks(link_first, links);
+
+    std::vector<road::Cell> cells;
+    std::vector<uint32_t> buckets;
+    buildGrid(cells, buckets);
+    const uint32_t cell_count = static_cast<uint32_t>(cells.size());
+    cells.push_back({UINT32_MAX, static_cast<uint32_t>(buckets.size())});
+
+    road::FileHeader header{};
+    header.magic = road::kFileMagic;
+    header.version = road::kFormatVersion;
+    header.cell_e7 = cell_e7_;
+    header.way_count = static_cast<uint32_t>(ways_.size());
+    header.point_count = static_cast<uint32_t>(points_.size());
+    header.link_count = static_cast<uint32_t>(links.size());
+    header.cell_count = cell_count;
+    header.bucket_count = static_cast<uint32_t>(buckets.size());
+    header.names_size = static_cast<uint32_t>(names_.size());
+
+    uint64_t offset = sizeof(header);
+    const auto place = [&offset](uint64_t& field, uint64_t bytes) {
+        field = offset;
+        offset = alignUp(offset + bytes);
+    };
+    place(header.ways_offset, ways_.size() * sizeof(road::Way));
+    place(header.points_offset, points_.size() * sizeof(road::Point));
+    place(header.link_first_offset, link_first.size() * sizeof(uint32_t));
+    place(header.links_offset, links.size() * sizeof(uint32_t));
+    place(header.cells_offset, cells.size() * sizeof(road::Cell));
+    place(header.buckets_offset, buckets.size() * sizeof(uint32_t));
+    place(header.names_offset, names_.size());
+    header.header_crc = road::fileHeaderCrc(header);
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    uint64_t written = 0U;
+    const auto section = [&](uint64_t at, const void* data, size_t length) {
+        static constexpr char kZeros[8]{};
+        bool ok = writeBytes(out, kZeros, at - written);
+        ok = ok && writeBytes(out, data, length);
+        written = at + length;
+        return ok;
+    };
+
+    bool ok = writeBytes(out, &header, sizeof(header));
+    written = sizeof(header);
+    ok = ok && section(header.ways_offset, ways_.data(), ways_.size() * sizeof(road::Way));
+    ok = ok && section(header.points_offset, points_.data(), points_.size() * sizeof(road::Point));
+    ok = ok && section(header.link_first_offset, link_first.data(), link_first.size() * sizeof(uint32_t));
+    ok = ok && section(header.links_offset, links.data(), links.size() * sizeof(uint32_t));
+    ok = ok && section(header.cells_offset, cells.data(), cells.size() * sizeof(road::Cell));
+    ok = ok && section(header.buckets_offset, buckets.data(), buckets.size() * sizeof(uint32_t));
+    ok = ok && section(header.names_offset, names_.data(), names_.size());
+    out.close();
+
+    std::error_code ec;
+    if (ok)
+        std::filesystem::rename(temporary, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
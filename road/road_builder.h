@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "road_format.h"
+
+// Collects ways in any order and writes them as a .mroad index. Runs
+// offline (motohud-roads build); the whole extract is held in memory.
+class RoadBuilder {
+    public:
+    explicit RoadBuilder(int32_t cell_e7 = road::kDefaultCellE7);
+
+    // false for fewer than two points; points run in the direction of
+    // travel for one-way roads
+    bool add(const std::string& name, uint8_t max_speed, uint8_t flags, const std::vector<road::Point>& points);
+
+    // writes to a temporary file and renames it over `path`
+    bool write(const std::filesystem::path& path);
+
+    size_t wayCount() const { return ways_.size(); }
+    size_t pointCount() const { return points_.size(); }
+    size_t segmentCount() const { return points_.size() - ways_.size(); }
+
+    private:
+    int32_t cell_e7_;
+    std::vector<road::Way> ways_;
+    std::vector<road::Point> points_;
+    std::vector<uint32_t> point_way_;
+    std::string names_;
+    std::unordered_map<std::string, uint32_t> name_offsets_;
+
+    void buildLinks(std::vector<uint32_t>& link_first, std::vector<uint32_t>& links) const;
+    void buildGrid(std::vector<road::Cell>& cells, std::vector<uint32_t>& buckets) const;
+};
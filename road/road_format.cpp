@@ -0,0 +1,14 @@
+#include "road_format.h"
+
+#include <boost/crc.hpp>
+
+namespace road {
+
+uint32_t fileHeaderCrc(const FileHeader& header)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(&header, offsetof(FileHeader, header_crc));
+    return crc.checksum();
+}
+
+} // namespace road
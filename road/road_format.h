@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/geo_grid.h"
+
+// On-disk layout of a road segment index (.mroad), built offline by
+// motohud-roads from an OpenStreetMap extract and memory mapped read-only
+// by the HUD.
+//
+// Every way is a run of points in the Point array; a segment is named by
+// the index of its first point and runs to the next point of the same way.
+// Segments are bucketed into the geo_grid like the POI index (sorted
+// non-empty Cell entries, then a sentinel; a cell's segment ids are
+// contiguous in the Bucket array). Links connect ways at shared points:
+// the segments of other ways touching point p are links[link_first[p] ..
+// link_first[p + 1]).
+//
+//   FileHeader | Way[way_count] | Point[point_count] |
+//   uint32 link_first[point_count + 1] | uint32 links[link_count] |
+//   Cell[cell_count + 1] | uint32 buckets[bucket_count] | names
+//
+// Sections are 8 byte aligned.
+
+namespace road {
+
+static constexpr uint32_t kFileMagic{0x44524D4DU}; // "MMRD"
+static constexpr uint16_t kFormatVersion{1U};
+static constexpr const char* kFileExtension{".mroad"};
+
+static constexpr int32_t kDefaultCellE7{20000}; // 0.002 deg, ~220 m of latitude
+
+enum WayFlags : uint8_t {
+    kOneway = 0x01U,   // drivable only from the first point to the last
+    kLimitMph = 0x02U, // max_speed is in mph, else km/h
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved0;
+    int32_t cell_e7;
+    uint32_t way_count;
+    uint32_t point_count;
+    uint32_t link_count;
+    uint32_t cell_count; // without the sentinel
+    uint32_t bucket_count;
+    uint32_t names_size;
+    uint32_t reserved1;
+    uint64_t ways_offset;
+    uint64_t points_offset;
+    uint64_t link_first_offset;
+    uint64_t links_offset;
+    uint64_t cells_offset;
+    uint64_t buckets_offset;
+    uint64_t names_offset;
+    uint32_t reserved2;
+    uint32_t header_crc; // crc32 of the preceding fields
+};
+
+struct Way {
+    uint32_t first_point;
+    uint32_t point_count;
+    uint32_t name;      // offset into the names section
+    uint8_t max_speed;  // posted limit, 0 if unknown
+    uint8_t flags;      // WayFlags
+    uint16_t reserved;
+};
+
+struct Point {
+    int32_t lat; // 1e-7 degrees
+    int32_t lon; // 1e-7 degrees
+};
+
+struct Cell {
+    uint32_t key;
+    uint32_t first; // index of the cell's first bucket entry
+};
+
+static_assert(sizeof(FileHeader) == 104, "road header layout changed");
+static_assert(sizeof(Way) == 16, "road way layout changed");
+
+uint32_t fileHeaderCrc(const FileHeader& header);
+
+} // namespace road
@@ -0,0 +1,150 @@
+#include "road_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/geodesy.h"
+
+RoadIndex::RoadIndex(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(road::FileHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return;
+
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+    std::memcpy(&header_, data_, sizeof(header_));
+
+    if (!validate()) {
+        ::munmap(map, size_);
+        data_ = nullptr;
+        size_ = 0U;
+        return;
+    }
+
+    ways_ = reinterpret_cast<const road::Way*>(data_ + header_.ways_offset);
+    points_ = reinterpret_cast<const road::Point*>(data_ + header_.points_offset);
+    link_first_ = reinterpret_cast<const uint32_t*>(data_ + header_.link_first_offset);
+    links_ = reinterpret_cast<const uint32_t*>(data_ + header_.links_offset);
+    cells_ = reinterpret_cast<const road::Cell*>(data_ + header_.cells_offset);
+    buckets_ = reinterpret_cast<const uint32_t*>(data_ + header_.buckets_offset);
+    names_ = reinterpret_cast<const char*>(data_ + header_.names_offset);
+}
+
+RoadIndex::~RoadIndex()
+{
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+bool RoadIndex::validate() const
+{
+    const road::FileHeader& h = header_;
+    if (h.magic != road::kFileMagic || h.version != road::kFormatVersion ||
+        h.header_crc != road::fileHeaderCrc(h) || h.cell_e7 < geo_grid::kMinCellE7 ||
+        h.point_count < h.way_count)
+        return false;
+
+    const auto fits = [this](uint64_t offset, uint64_t length) {
+        return offset % 8U == 0U && offset <= size_ && length <= size_ - offset;
+    };
+    if (!fits(h.ways_offset, uint64_t{h.way_count} * sizeof(road::Way)) ||
+        !fits(h.points_offset, uint64_t{h.point_count} * sizeof(road::Point)) ||
+        !fits(h.link_first_offset, (uint64_t{h.point_count} + 1U) * sizeof(uint32_t)) ||
+        !fits(h.links_offset, uint64_t{h.link_count} * sizeof(uint32_t)) ||
+        !fits(h.cells_offset, (uint64_t{h.cell_count} + 1U) * sizeof(road::Cell)) ||
+        !fits(h.buckets_offset, uint64_t{h.bucket_count} * sizeof(uint32_t)) || !fits(h.names_offset, h.names_size))
+        return false;
+
+    // the header crc says nothing about the sections; the sentinels have to
+    // close their arrays and the first way has to start at point 0, so
+    // wayOf() always lands on a way. Entries are bounded where they are used.
+    road::Cell sentinel;
+    std::memcpy(&sentinel, data_ + h.cells_offset + uint64_t{h.cell_count} * sizeof(road::Cell), sizeof(sentinel));
+    uint32_t links_end;
+    std::memcpy(&links_end, data_ + h.link_first_offset + uint64_t{h.point_count} * sizeof(uint32_t),
+                sizeof(links_end));
+    road::Way first_way{};
+    if (h.way_count > 0U)
+        std::memcpy(&first_way, data_ + h.ways_offset, sizeof(first_way));
+    return sentinel.first == h.bucket_count && links_end == h.link_count && first_way.first_point == 0U;
+}
+
+uint32_t RoadIndex::wayOf(uint32_t segment) const
+{
+    // last way starting at or before the point
+    const road::Way* end = ways_ + header_.way_count;
+    const road::Way* it = std::upper_bound(ways_, end, segment,
+                                           [](uint32_t p, const road::Way& w) { return p < w.first_point; });
+    return static_cast<uint32_t>(it - ways_) - 1U;
+}
+
+std::string_view RoadIndex::name(const road::Way& way) const
+{
+    if (way.name >= header_.names_size)
+        return {};
+    return {names_ + way.name, ::strnlen(names_ + way.name, header_.names_size - way.name)};
+}
+
+size_t RoadIndex::neighbours(uint32_t segment, uint32_t* out, size_t max_out) const
+{
+    if (!isSegment(segment))
+        return 0U;
+
+    const road::Way& w = ways_[wayOf(segment)];
+    size_t count = 0U;
+    const auto add = [&](uint32_t s) {
+        if (count < max_out)
+            out[count++] = s;
+    };
+
+    if (segment > w.first_point)
+        add(segment - 1U);
+    if (segment + 2U < w.first_point + w.point_count)
+        add(segment + 1U);
+
+    for (const uint32_t end : {segment, segment + 1U}) {
+        const uint32_t last = std::min(link_first_[end + 1U], header_.link_count);
+        for (uint32_t i = link_first_[end]; i < last; ++i) {
+            if (isSegment(links_[i]))
+                add(links_[i]);
+        }
+    }
+    return count;
+}
+
+void RoadIndex::cellRange(int32_t lat, int32_t lon, float radius_m, uint32_t& row_min, uint32_t& row_max,
+                          uint32_t& col_min, uint32_t& col_max) const
+{
+    const double cos_lat = std::max(std::cos(lat * 1e-7 * M_PI / 180.0), 0.01);
+    const int64_t dlat = static_cast<int64_t>(radius_m / geodesy::kMetersPerE7) + 1;
+    const int64_t dlon = static_cast<int64_t>(radius_m / (geodesy::kMetersPerE7 * cos_lat)) + 1;
+
+    row_min = geo_grid::row(geo_grid::clampLat(int64_t{lat} - dlat), header_.cell_e7);
+    row_max = geo_grid::row(geo_grid::clampLat(int64_t{lat} + dlat), header_.cell_e7);
+    col_min = geo_grid::column(geo_grid::clampLon(int64_t{lon} - dlon), header_.cell_e7);
+    col_max = geo_grid::column(geo_grid::clampLon(int64_t{lon} + dlon), header_.cell_e7);
+}
+
+const road::Cell* RoadIndex::firstCell(uint32_t key) const
+{
+    return std::lower_bound(cells_, cells_ + header_.cell_count, key,
+                            [](const road::Cell& c, uint32_t k) { return c.key < k; });
+}
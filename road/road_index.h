@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "road_format.h"
+
+// Memory mapped, read-only view of a .mroad index. Opening validates the
+// header, section bounds and sentinels only; pages fault in as matching
+// touches them, so a whole region costs address space, not resident
+// memory. Bucket and link entries are checked as they are read, and ones
+// naming no segment are skipped.
+class RoadIndex {
+    public:
+    explicit RoadIndex(const std::filesystem::path& path);
+    ~RoadIndex();
+
+    RoadIndex(const RoadIndex&) = delete;
+    RoadIndex& operator=(const RoadIndex&) = delete;
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t wayCount() const { return isOpen() ? header_.way_count : 0U; }
+    size_t pointCount() const { return isOpen() ? header_.point_count : 0U; }
+    size_t segmentCount() const { return pointCount() - wayCount(); }
+    size_t cellCount() const { return isOpen() ? header_.cell_count : 0U; }
+    size_t linkCount() const { return isOpen() ? header_.link_count : 0U; }
+    int32_t cellE7() const { return header_.cell_e7; }
+    size_t mappedBytes() const { return size_; }
+
+    // a segment id is the index of its first point
+    bool isSegment(uint32_t s) const { return s + 1U < pointCount(); }
+    const road::Point& point(uint32_t p) const { return points_[p]; }
+    uint32_t wayOf(uint32_t segment) const;
+    const road::Way& way(uint32_t w) const { return ways_[w]; }
+    std::string_view name(const road::Way& way) const;
+
+    // every segment bucketed in a cell within radius_m of the position;
+    // a segment crossing several cells can come up more than once
+    template <typename Visitor>
+    void forEachSegmentNear(int32_t lat, int32_t lon, float radius_m, Visitor&& visit) const;
+
+    // segments continuing from `segment`: its neighbours along the way and
+    // the segments of other ways at both of its ends. Returns the count
+    // written, at most max_out.
+    size_t neighbours(uint32_t segment, uint32_t* out, size_t max_out) const;
+
+    private:
+    const uint8_t* data_{};
+    size_t size_{};
+    road::FileHeader header_{};
+    const road::Way* ways_{};
+    const road::Point* points_{};
+    const uint32_t* link_first_{};
+    const uint32_t* links_{};
+    const road::Cell* cells_{};
+    const uint32_t* buckets_{};
+    const char* names_{};
+
+    bool validate() const;
+    void cellRange(int32_t lat, int32_t lon, float radius_m, uint32_t& row_min, uint32_t& row_max,
+                   uint32_t& col_min, uint32_t& col_max) const;
+    const road::Cell* firstCell(uint32_t key) const;
+};
+
+template <typename Visitor>
+void RoadIndex::forEachSegmentNear(int32_t lat, int32_t lon, float radius_m, Visitor&& visit) const
+{
+    if (!isOpen() || header_.cell_count == 0U)
+        return;
+
+    uint32_t row_min, row_max, col_min, col_max;
+    cellRange(lat, lon, radius_m, row_min, row_max, col_min, col_max);
+
+    const road::Cell* cells_end = cells_ + header_.cell_count;
+    for (uint32_t row = row_min; row <= row_max; ++row) {
+        const uint32_t key_max = geo_grid::key(row, col_max, header_.cell_e7);
+        for (const road::Cell* cell = firstCell(geo_grid::key(row, col_min, header_.cell_e7));
+             cell != cells_end && cell->key <= key_max; ++cell) {
+            const uint32_t end = std::min((cell + 1)->first, header_.bucket_count);
+            for (uint32_t i = cell->first; i < end; ++i) {
+                if (isSegment(buckets_[i]))
+                    visit(buckets_[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "road_matcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/geodesy.h"
+
+namespace {
+constexpr double kDegToRad{M_PI / 180.0};
+} // namespace
+
+RoadMatcher::RoadMatcher(std::unique_ptr<RoadIndex> index)
+    : RoadMatcher(std::move(index), Config{})
+{
+}
+
+RoadMatcher::RoadMatcher(std::unique_ptr<RoadIndex> index, Config config)
+    : index_(std::move(index))
+    , config_(config)
+{
+}
+
+const road::Match& RoadMatcher::update(const GnssPvt& pvt)
+{
+    ++stats_.epochs;
+
+    const bool use_heading = pvt.velocity_2d >= config_.min_heading_speed_mps;
+    const double cos_lat = std::max(std::cos(pvt.position.lat * 1e-7 * kDegToRad), 0.01);
+
+    Candidate best;
+    if (match_.valid) {
+        consider(match_.segment, pvt, use_heading, cos_lat, best);
+        uint32_t next[kMaxNeighbours];
+        const size_t count = index_->neighbours(match_.segment, next, kMaxNeighbours);
+        for (size_t i = 0; i < count; ++i)
+            consider(next[i], pvt, use_heading, cos_lat, best);
+    }
+
+    if (!best.valid || best.distance_m > config_.coherent_accept_m) {
+        ++stats_.grid_searches;
+        index_->forEachSegmentNear(pvt.position.lat, pvt.position.lon, config_.max_distance_m,
+                                   [&](uint32_t segment) { consider(segment, pvt, use_heading, cos_lat, best); });
+    } else {
+        ++stats_.coherent;
+    }
+
+    accept(best);
+    return match_;
+}
+
+void RoadMatcher::consider(uint32_t segment, const GnssPvt& pvt, bool use_heading, double cos_lat,
+                           Candidate& best) const
+{
+    const road::Point& a = index_->point(segment);
+    const road::Point& b = index_->point(segment + 1U);
+
+    // local meters around the bike; integers differenced before scaling
+    const double k = geodesy::kMetersPerE7;
+    const double ax = (static_cast<int64_t>(a.lon) - pvt.position.lon) * k * cos_lat;
+    const double ay = (static_cast<int64_t>(a.lat) - pvt.position.lat) * k;
+    const double dx = (static_cast<int64_t>(b.lon) - a.lon) * k * cos_lat;
+    const double dy = (static_cast<int64_t>(b.lat) - a.lat) * k;
+
+    const double length2 = dx * dx + dy * dy;
+    const double t = length2 > 0.0 ? std::clamp(-(ax * dx + ay * dy) / length2, 0.0, 1.0) : 0.0;
+    const float distance = static_cast<float>(std::hypot(ax + t * dx, ay + t * dy));
+    if (distance > config_.max_distance_m)
+        return;
+
+    // only candidates that got this far pay for the way lookup
+    const uint32_t way = index_->wayOf(segment);
+    float heading_diff = 0.0f;
+    if (use_heading) {
+        const float bearing = static_cast<float>(std::atan2(dx, dy) / kDegToRad);
+        heading_diff = std::fabs(std::remainder(pvt.heading - bearing, 360.0f));
+        if (!(index_->way(way).flags & road::kOneway))
+            heading_diff = std::min(heading_diff, 180.0f - heading_diff);
+        if (heading_diff > config_.max_heading_diff_deg)
+            return;
+    }
+
+    float score = distance + config_.heading_weight_m_per_deg * heading_diff;
+    if (way == way_)
+        score -= config_.same_way_bonus_m;
+
+    if (!best.valid || score < best.score)
+        best = Candidate{segment, distance, score, true};
+}
+
+void RoadMatcher::accept(const Candidate& best)
+{
+    if (!best.valid) {
+        match_ = road::Match{};
+        way_ = UINT32_MAX;
+        return;
+    }
+
+    const uint32_t way = index_->wayOf(best.segment);
+    if (!match_.valid || way != way_) {
+        // strings only change with the way
+        const road::Way& w = index_->way(way);
+        match_.name = std::string(index_->name(w));
+        match_.max_speed = w.max_speed;
+        match_.limit_mph = (w.flags & road::kLimitMph) != 0U;
+        way_ = way;
+    }
+    match_.valid = true;
+    match_.segment = best.segment;
+    match_.distance_m = best.distance_m;
+}
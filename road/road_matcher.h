@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "core/gnss_pvt.h"
+#include "road_index.h"
+
+namespace road {
+
+struct Match {
+    bool valid{};
+    uint32_t segment{};
+    std::string name;
+    uint8_t max_speed{}; // posted limit, 0 if unknown
+    bool limit_mph{};
+    float distance_m{};  // from the segment
+};
+
+} // namespace road
+
+// Snaps each epoch to a road segment. Candidates must be close and run the
+// way the bike is heading (either way unless one-way). The previous match
+// and the segments continuing from it are tried first; the grid is only
+// searched when none of them is a confident match, which on a normal ride
+// is at junction-free stretches almost never.
+class RoadMatcher {
+    public:
+    struct Config {
+        float max_distance_m{35.0f};
+        float max_heading_diff_deg{45.0f};
+        float min_heading_speed_mps{2.0f};    // slower: heading ignored
+        float heading_weight_m_per_deg{0.2f}; // score = distance + weight * heading diff
+        float same_way_bonus_m{3.0f};         // hysteresis against parallel roads
+        float coherent_accept_m{12.0f};       // neighbour this close: skip the grid
+    };
+
+    struct Stats {
+        uint64_t epochs{};
+        uint64_t coherent{};     // answered from the previous segment's neighbourhood
+        uint64_t grid_searches{};
+    };
+
+    explicit RoadMatcher(std::unique_ptr<RoadIndex> index);
+    RoadMatcher(std::unique_ptr<RoadIndex> index, Config config);
+
+    // once per epoch
+    const road::Match& update(const GnssPvt& pvt);
+    const road::Match& match() const { return match_; }
+    const Stats& stats() const { return stats_; }
+
+    const RoadIndex& index() const { return *index_; }
+
+    private:
+    struct Candidate {
+        uint32_t segment{};
+        float distance_m{};
+        float score{};
+        bool valid{};
+    };
+
+    static constexpr size_t kMaxNeighbours{16U};
+
+    std::unique_ptr<RoadIndex> index_;
+    Config config_;
+    road::Match match_;
+    uint32_t way_{UINT32_MAX};
+    Stats stats_;
+
+    void consider(uint32_t segment, const GnssPvt& pvt, bool use_heading, double cos_lat, Candidate& best) const;
+    void accept(const Candidate& best);
+};
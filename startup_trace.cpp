@@ -0,0 +1,36 @@
+#include "startup_trace.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace startup {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const Clock::time_point process_start = Clock::now();
+Clock::time_point last_mark = process_start;
+
+double toMs(Clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} // namespace
+
+double elapsedMs()
+{
+    return toMs(Clock::now() - process_start);
+}
+
+void mark(const char* phase)
+{
+    const auto now = Clock::now();
+    std::printf("startup: %-28s %8.1f ms (+%.1f ms)\n", phase, toMs(now - process_start),
+                toMs(now - last_mark));
+    std::fflush(stdout);
+    last_mark = now;
+}
+
+} // namespace startup
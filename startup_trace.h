@@ -0,0 +1,14 @@
+#pragma once
+
+// Startup phase timing. Times are measured from static initialisation of the
+// executable, which is as close to process start as we can get without
+// asking the kernel.
+namespace startup {
+
+// milliseconds since process start
+double elapsedMs();
+
+// prints the phase with its absolute time and the time since the last mark
+void mark(const char* phase);
+
+} // namespace startup
@@ -0,0 +1,215 @@
+// motohud-poi: builds and inspects point of interest indexes (.mpoi).
+//
+//   motohud-poi build OUT.mpoi [--cell-deg DEG] POINTS.csv...
+//   motohud-poi info INDEX.mpoi
+//   motohud-poi query INDEX.mpoi LAT LON HEADING_DEG SPEED_MPS
+//   motohud-poi bench INDEX.mpoi [QUERIES]
+//
+// Input lines are "lat,lon,category,name" in decimal degrees; the name is
+// the rest of the line and may contain commas. Empty lines and lines
+// starting with '#' are skipped.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "core/gnss_pvt.h"
+#include "poi/poi_alerter.h"
+#include "poi/poi_builder.h"
+#include "poi/poi_index.h"
+
+namespace {
+
+int usage()
+{
+    std::cerr << "usage: motohud-poi build OUT.mpoi [--cell-deg DEG] POINTS.csv...\n"
+                 "       motohud-poi info INDEX.mpoi\n"
+                 "       motohud-poi query INDEX.mpoi LAT LON HEADING_DEG SPEED_MPS\n"
+                 "       motohud-poi bench INDEX.mpoi [QUERIES]\n";
+    return EXIT_FAILURE;
+}
+
+int32_t toE7(double degrees)
+{
+    return static_cast<int32_t>(std::llround(degrees * 1e7));
+}
+
+bool parseLine(const std::string& line, double& lat, double& lon, std::string& category, std::string& name)
+{
+    const size_t c1 = line.find(',');
+    const size_t c2 = c1 == std::string::npos ? c1 : line.find(',', c1 + 1);
+    const size_t c3 = c2 == std::string::npos ? c2 : line.find(',', c2 + 1);
+    if (c3 == std::string::npos)
+        return false;
+
+    char* end = nullptr;
+    lat = std::strtod(line.c_str(), &end);
+    if (end != line.c_str() + c1)
+        return false;
+    lon = std::strtod(line.c_str() + c1 + 1, &end);
+    if (end != line.c_str() + c2)
+        return false;
+
+    category = line.substr(c2 + 1, c3 - c2 - 1);
+    name = line.substr(c3 + 1);
+    return !category.empty();
+}
+
+int build(int argc, char** argv)
+{
+    if (argc < 4)
+        return usage();
+
+    int first_input = 3;
+    double cell_deg = poi::kDefaultCellE7 * 1e-7;
+    if (std::strcmp(argv[3], "--cell-deg") == 0) {
+        if (argc < 6)
+            return usage();
+        cell_deg = std::atof(argv[4]);
+        first_input = 5;
+    }
+
+    PoiBuilder builder(toE7(cell_deg));
+    uint64_t skipped = 0U;
+    for (int i = first_input; i < argc; ++i) {
+        std::ifstream in(argv[i]);
+        if (!in) {
+            std::cerr << "cannot open " << argv[i] << "\n";
+            return EXIT_FAILURE;
+        }
+
+        std::string line, category, name;
+        double lat{}, lon{};
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!parseLine(line, lat, lon, category, name) || !builder.add(toE7(lat), toE7(lon), category, name))
+                ++skipped;
+        }
+    }
+
+    if (!builder.write(argv[2])) {
+        std::cerr << "failed writing " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << builder.size() << " points in " << builder.categoryCount() << " categories, "
+              << skipped << " lines skipped\n";
+    return EXIT_SUCCESS;
+}
+
+int info(const char* path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    PoiIndex index(path);
+    const auto open_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    if (!index.isOpen()) {
+        std::cerr << path << ": not a poi index\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "points: " << index.size() << "\n"
+              << "cells: " << index.cellCount() << "\n"
+              << "cell deg: " << index.cellE7() * 1e-7 << "\n"
+              << "bytes: " << index.mappedBytes() << "\n"
+              << "open us: " << open_us << "\n"
+              << "categories:";
+    for (uint16_t i = 0; i < index.categoryCount(); ++i)
+        std::cout << " " << index.categoryName(i);
+    std::cout << "\n";
+    return EXIT_SUCCESS;
+}
+
+int query(int argc, char** argv)
+{
+    if (argc < 7)
+        return usage();
+
+    auto index = std::make_unique<PoiIndex>(argv[2]);
+    if (!index->isOpen()) {
+        std::cerr << argv[2] << ": not a poi index\n";
+        return EXIT_FAILURE;
+    }
+
+    // same cone the HUD uses
+    GnssPvt pvt{};
+    pvt.position.lat = toE7(std::atof(argv[3]));
+    pvt.position.lon = toE7(std::atof(argv[4]));
+    pvt.heading = static_cast<float>(std::atof(argv[5]));
+    pvt.velocity_2d = static_cast<float>(std::atof(argv[6]));
+
+    PoiAlerter alerter(std::move(index));
+    const poi::Alert& alert = alerter.update(pvt, 0);
+    if (!alert.active) {
+        std::cout << "nothing ahead\n";
+        return EXIT_SUCCESS;
+    }
+    std::cout << alert.category << " " << alert.name << " " << alert.distance_m << " m, "
+              << alert.relative_bearing_deg << " deg off the nose\n";
+    return EXIT_SUCCESS;
+}
+
+int bench(int argc, char** argv)
+{
+    PoiIndex index(argv[2]);
+    if (!index.isOpen() || index.size() == 0U) {
+        std::cerr << argv[2] << ": not a poi index, or empty\n";
+        return EXIT_FAILURE;
+    }
+    const int queries = argc > 3 ? std::atoi(argv[3]) : 100000;
+
+    // positions near real points, so the queries land in populated cells
+    std::mt19937 rng(1U);
+    std::uniform_int_distribution<uint32_t> pick(0U, static_cast<uint32_t>(index.size() - 1U));
+    std::uniform_int_distribution<int32_t> jitter(-20000, 20000);
+    std::uniform_real_distribution<float> heading(0.0f, 360.0f);
+
+    PoiIndex::Hit hits[4];
+    uint64_t found = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i) {
+        const poi::Poi& p = index.at(pick(rng));
+        PoiIndex::Cone cone;
+        cone.lat = p.lat + jitter(rng);
+        cone.lon = p.lon + jitter(rng);
+        cone.heading_deg = heading(rng);
+        cone.range_m = 1000.0f;
+        cone.near_m = 60.0f;
+        found += index.query(cone, hits, 4U);
+    }
+    const double elapsed_us = std::chrono::duration<double, std::micro>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+
+    std::cout << queries << " queries, " << found << " hits, "
+              << elapsed_us / queries << " us per query\n";
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return usage();
+
+    const std::string command = argv[1];
+    if (command == "build")
+        return build(argc, argv);
+    if (command == "info")
+        return info(argv[2]);
+    if (command == "query")
+        return query(argc, argv);
+    if (command == "bench")
+        return bench(argc, argv);
+    return usage();
+}
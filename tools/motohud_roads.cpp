@@ -0,0 +1,270 @@
+// motohud-roads: builds and inspects road segment indexes (.mroad).
+//
+//   motohud-roads build OUT.mroad [--cell-deg DEG] WAYS.txt...
+//   motohud-roads info INDEX.mroad
+//   motohud-roads match INDEX.mroad LAT LON HEADING_DEG SPEED_MPS
+//   motohud-roads bench INDEX.mroad [RIDES]
+//
+// Input is one OSM way per line, tab separated:
+//
+//   name <TAB> maxspeed <TAB> oneway <TAB> lat,lon lat,lon ...
+//
+// with the OSM tag values as they are ("50", "30 mph", "none", "yes",
+// "-1", empty), e.g. from `osmium export -f geojsonseq` piped through a
+// few lines of jq. Empty lines and lines starting with '#' are skipped.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/geodesy.h"
+#include "core/gnss_pvt.h"
+#include "road/road_builder.h"
+#include "road/road_index.h"
+#include "road/road_matcher.h"
+
+namespace {
+
+int usage()
+{
+    std::cerr << "usage: motohud-roads build OUT.mroad [--cell-deg DEG] WAYS.txt...\n"
+                 "       motohud-roads info INDEX.mroad\n"
+                 "       motohud-roads match INDEX.mroad LAT LON HEADING_DEG SPEED_MPS\n"
+                 "       motohud-roads bench INDEX.mroad [RIDES]\n";
+    return EXIT_FAILURE;
+}
+
+int32_t toE7(double degrees)
+{
+    return static_cast<int32_t>(std::llround(degrees * 1e7));
+}
+
+void parseMaxSpeed(const std::string& tag, uint8_t& max_speed, uint8_t& flags)
+{
+    // "50", "50 km/h", "30 mph"; "none", "signals", "walk" etc. are unknown
+    const long value = std::strtol(tag.c_str(), nullptr, 10);
+    max_speed = static_cast<uint8_t>(std::clamp<long>(value, 0, 255));
+    if (tag.find("mph") != std::string::npos)
+        flags |= road::kLimitMph;
+}
+
+bool parseLine(const std::string& line, std::string& name, uint8_t& max_speed, uint8_t& flags,
+               std::vector<road::Point>& points)
+{
+    const size_t t1 = line.find('\t');
+    const size_t t2 = t1 == std::string::npos ? t1 : line.find('\t', t1 + 1);
+    const size_t t3 = t2 == std::string::npos ? t2 : line.find('\t', t2 + 1);
+    if (t3 == std::string::npos)
+        return false;
+
+    name = line.substr(0, t1);
+    flags = 0U;
+    parseMaxSpeed(line.substr(t1 + 1, t2 - t1 - 1), max_speed, flags);
+
+    const std::string oneway = line.substr(t2 + 1, t3 - t2 - 1);
+    const bool reverse = oneway == "-1" || oneway == "reverse";
+    if (oneway == "yes" || oneway == "true" || oneway == "1" || reverse)
+        flags |= road::kOneway;
+
+    points.clear();
+    std::istringstream coordinates(line.substr(t3 + 1));
+    std::string pair;
+    while (coordinates >> pair) {
+        const size_t comma = pair.find(',');
+        if (comma == std::string::npos)
+            return false;
+        points.push_back({toE7(std::atof(pair.c_str())), toE7(std::atof(pair.c_str() + comma + 1))});
+    }
+    if (reverse)
+        std::reverse(points.begin(), points.end());
+    return points.size() >= 2U;
+}
+
+int build(int argc, char** argv)
+{
+    if (argc < 4)
+        return usage();
+
+    int first_input = 3;
+    double cell_deg = road::kDefaultCellE7 * 1e-7;
+    if (std::strcmp(argv[3], "--cell-deg") == 0) {
+        if (argc < 6)
+            return usage();
+        cell_deg = std::atof(argv[4]);
+        first_input = 5;
+    }
+
+    RoadBuilder builder(toE7(cell_deg));
+    uint64_t skipped = 0U;
+    for (int i = first_input; i < argc; ++i) {
+        std::ifstream in(argv[i]);
+        if (!in) {
+            std::cerr << "cannot open " << argv[i] << "\n";
+            return EXIT_FAILURE;
+        }
+
+        std::string line, name;
+        std::vector<road::Point> points;
+        uint8_t max_speed{}, flags{};
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (!parseLine(line, name, max_speed, flags, points) || !builder.add(name, max_speed, flags, points))
+                ++skipped;
+        }
+    }
+
+    if (!builder.write(argv[2])) {
+        std::cerr << "failed writing " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << builder.wayCount() << " ways, " << builder.segmentCount() << " segments, "
+              << skipped << " lines skipped\n";
+    return EXIT_SUCCESS;
+}
+
+int info(const char* path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    RoadIndex index(path);
+    const auto open_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    if (!index.isOpen()) {
+        std::cerr << path << ": not a road index\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "ways: " << index.wayCount() << "\n"
+              << "segments: " << index.segmentCount() << "\n"
+              << "links: " << index.linkCount() << "\n"
+              << "cells: " << index.cellCount() << "\n"
+              << "cell deg: " << index.cellE7() * 1e-7 << "\n"
+              << "bytes: " << index.mappedBytes() << "\n"
+              << "open us: " << open_us << "\n";
+    return EXIT_SUCCESS;
+}
+
+void printMatch(const road::Match& match)
+{
+    if (!match.valid) {
+        std::cout << "no road\n";
+        return;
+    }
+    std::cout << (match.name.empty() ? "(unnamed)" : match.name) << ", limit ";
+    if (match.max_speed == 0U)
+        std::cout << "unknown";
+    else
+        std::cout << int{match.max_speed} << (match.limit_mph ? " mph" : " km/h");
+    std::cout << ", " << match.distance_m << " m off\n";
+}
+
+int match(int argc, char** argv)
+{
+    if (argc < 7)
+        return usage();
+
+    auto index = std::make_unique<RoadIndex>(argv[2]);
+    if (!index->isOpen()) {
+        std::cerr << argv[2] << ": not a road index\n";
+        return EXIT_FAILURE;
+    }
+
+    GnssPvt pvt{};
+    pvt.position.lat = toE7(std::atof(argv[3]));
+    pvt.position.lon = toE7(std::atof(argv[4]));
+    pvt.heading = static_cast<float>(std::atof(argv[5]));
+    pvt.velocity_2d = static_cast<float>(std::atof(argv[6]));
+
+    RoadMatcher matcher(std::move(index));
+    printMatch(matcher.update(pvt));
+    return EXIT_SUCCESS;
+}
+
+int bench(int argc, char** argv)
+{
+    auto owned = std::make_unique<RoadIndex>(argv[2]);
+    if (!owned->isOpen() || owned->wayCount() == 0U) {
+        std::cerr << argv[2] << ": not a road index, or empty\n";
+        return EXIT_FAILURE;
+    }
+    const RoadIndex& index = *owned;
+    RoadMatcher matcher(std::move(owned));
+    const int rides = argc > 3 ? std::atoi(argv[3]) : 1000;
+
+    // ride along random ways at 15 m/s, 10 Hz, with a few meters of noise
+    std::mt19937 rng(1U);
+    std::uniform_int_distribution<uint32_t> pick(0U, static_cast<uint32_t>(index.wayCount() - 1U));
+    std::normal_distribution<double> noise(0.0, 3.0);
+
+    uint64_t epochs = 0U, on_way = 0U;
+    double elapsed_us = 0.0;
+    for (int ride = 0; ride < rides; ++ride) {
+        const uint32_t way = pick(rng);
+        const road::Way& w = index.way(way);
+        for (uint32_t s = w.first_point; s + 1U < w.first_point + w.point_count; ++s) {
+            const road::Point& a = index.point(s);
+            const road::Point& b = index.point(s + 1U);
+            const double cos_lat = std::cos(a.lat * 1e-7 * M_PI / 180.0);
+            const double north = (b.lat - a.lat) * geodesy::kMetersPerE7;
+            const double east = (b.lon - a.lon) * geodesy::kMetersPerE7 * cos_lat;
+            const double length = std::hypot(north, east);
+            const int steps = std::max(1, static_cast<int>(length / 1.5));
+
+            GnssPvt pvt{};
+            pvt.velocity_2d = 15.0f;
+            pvt.heading = static_cast<float>(std::fmod(std::atan2(east, north) * 180.0 / M_PI + 360.0, 360.0));
+            for (int i = 0; i < steps; ++i) {
+                const double f = static_cast<double>(i) / steps;
+                pvt.position.lat = a.lat + static_cast<int32_t>(f * (b.lat - a.lat) + noise(rng) / geodesy::kMetersPerE7);
+                pvt.position.lon = a.lon + static_cast<int32_t>(f * (b.lon - a.lon) +
+                                                                noise(rng) / (geodesy::kMetersPerE7 * cos_lat));
+
+                const auto start = std::chrono::steady_clock::now();
+                const road::Match& m = matcher.update(pvt);
+                elapsed_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+                ++epochs;
+                if (m.valid && index.wayOf(m.segment) == way)
+                    ++on_way;
+            }
+        }
+    }
+
+    const RoadMatcher::Stats& stats = matcher.stats();
+    std::cout << epochs << " epochs, " << elapsed_us / std::max<uint64_t>(epochs, 1U) << " us per epoch, "
+              << 100.0 * on_way / std::max<uint64_t>(epochs, 1U) << "% on the ridden way, "
+              << 100.0 * stats.coherent / std::max<uint64_t>(stats.epochs, 1U) << "% answered from neighbours\n";
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return usage();
+
+    const std::string command = argv[1];
+    if (command == "build")
+        return build(argc, argv);
+    if (command == "info")
+        return info(argv[2]);
+    if (command == "match")
+        return match(argc, argv);
+    if (command == "bench")
+        return bench(argc, argv);
+    return usage();
+}
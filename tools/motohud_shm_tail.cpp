@@ -0,0 +1,62 @@
+// motohud-shm-tail: follows the HUD's shared memory epoch ring and prints
+// each epoch, as a minimal example of a local consumer.
+//
+//   motohud-shm-tail [--frames]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "ipc/gnss_shm.h"
+
+int main(int argc, char** argv)
+{
+    const bool frames = argc > 1 && std::strcmp(argv[1], "--frames") == 0;
+    const char* name = frames ? gnss_shm::kFrameRingName : gnss_shm::kEpochRingName;
+
+    ShmRingReader reader;
+    while (!reader.open(name)) {
+        std::cerr << "waiting for " << name << "\n";
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    uint64_t reported_lost = 0U;
+    while (true) {
+        ShmRingReader::View view;
+        switch (reader.next(view)) {
+        case ShmRingReader::Status::kOk: {
+            if (frames) {
+                const uint16_t id = static_cast<uint16_t>(view.data[2] << 8 | view.data[3]);
+                if (reader.stillValid(view))
+                    std::cout << view.sequence << " frame 0x" << std::hex << id << std::dec << " "
+                              << view.length << " bytes\n";
+                break;
+            }
+
+            gnss_shm::SharedEpoch epoch;
+            std::memcpy(&epoch, view.data, sizeof(epoch));
+            if (!reader.stillValid(view))
+                break;
+            std::cout << view.sequence << " itow " << epoch.nav_pvt.itow.value() << " lat "
+                      << epoch.nav_pvt.lat.value() * 1e-7 << " lon " << epoch.nav_pvt.lon.value() * 1e-7
+                      << " speed " << epoch.nav_pvt.ground_speed.value() * 1e-3 << " m/s sv "
+                      << static_cast<int>(epoch.nav_pvt.num_sv) << "\n";
+        } break;
+
+        case ShmRingReader::Status::kOverrun:
+            std::cerr << "overrun, " << reader.lost() - reported_lost << " records lost\n";
+            reported_lost = reader.lost();
+            break;
+
+        case ShmRingReader::Status::kEmpty:
+            if (!reader.writerAlive()) {
+                std::cerr << "writer gone\n";
+                return EXIT_SUCCESS;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            break;
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// motohud-track: packs ride logs into .mht tracks, exports tracks as GPX
+// or CSV and times the launches and stops in ride logs.
+//
+//   motohud-track pack OUT.mht RIDE.mhl...
+//   motohud-track runs RIDE.mhl...
+//   motohud-track info TRACK.mht
+//   motohud-track gpx|csv TRACK.mht [FROM_UNIX_MS [TO_UNIX_MS]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "core/performance_meter.h"
+#include "logging/ride_log_reader.h"
+#include "track/track_export.h"
+#include "track/track_reader.h"
+#include "track/track_writer.h"
+
+namespace {
+
+int usage()
+{
+    std::cerr << "usage: motohud-track pack OUT.mht RIDE.mhl...\n"
+                 "       motohud-track runs RIDE.mhl...\n"
+                 "       motohud-track info TRACK.mht\n"
+                 "       motohud-track gpx|csv TRACK.mht [FROM_UNIX_MS [TO_UNIX_MS]]\n";
+    return EXIT_FAILURE;
+}
+
+int pack(int argc, char** argv)
+{
+    if (argc < 4)
+        return usage();
+
+    TrackWriter writer;
+    if (!writer.open(argv[2])) {
+        std::cerr << "cannot create " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    uint64_t log_bytes = 0U;
+    for (int i = 3; i < argc; ++i) {
+        RideLogReader reader(argv[i]);
+        if (!reader.isOpen()) {
+            std::cerr << "skipping " << argv[i] << ": not a ride log\n";
+            continue;
+        }
+
+        RideLogReader::Record record;
+        while (reader.next(record)) {
+            if (record.type != ride_log::RecordType::kEpoch || record.length != sizeof(UbxNavPvtMsg))
+                continue;
+
+            UbxNavPvtMsg pvt;
+            std::memcpy(&pvt, record.payload, sizeof(pvt));
+            if (pvt.fix_type == 0U)
+                continue;
+            if (!writer.append(track::fromNavPvt(pvt))) {
+                std::cerr << "failed writing " << argv[2] << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+        log_bytes += reader.validEnd();
+    }
+
+    if (!writer.close()) {
+        std::cerr << "failed writing " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << writer.pointCount() << " points, " << log_bytes << " log bytes -> "
+              << writer.bytesWritten() << " track bytes\n";
+    return EXIT_SUCCESS;
+}
+
+int runs(int argc, char** argv)
+{
+    PerformanceMeter meter;
+    meter.setRunHandler([](const perf::Run& run) {
+        char line[160];
+        if (run.kind == perf::RunKind::kLaunch)
+            std::snprintf(line, sizeof(line), "%lld launch 0-30 %.3f 0-60 %.3f 1/4 %.3f @ %.1f mph",
+                          static_cast<long long>(run.start_unix_ms), run.zero_to_30_s, run.zero_to_60_s,
+                          run.quarter_mile_s, run.quarter_mile_mph);
+        else
+            std::snprintf(line, sizeof(line), "%lld braking 60-0 %.3f s %.2f m",
+                          static_cast<long long>(run.start_unix_ms), run.sixty_to_zero_s, run.sixty_to_zero_m);
+        std::cout << line << " ±" << run.uncertainty_ms << " ms at " << run.epoch_interval_ms << " ms"
+                  << (run.clean ? "" : " (not clean)") << "\n";
+    });
+
+    for (int i = 2; i < argc; ++i) {
+        RideLogReader reader(argv[i]);
+        if (!reader.isOpen()) {
+            std::cerr << "skipping " << argv[i] << ": not a ride log\n";
+            continue;
+        }
+
+        RideLogReader::Record record;
+        while (reader.next(record)) {
+            if (record.type != ride_log::RecordType::kEpoch || record.length != sizeof(UbxNavPvtMsg))
+                continue;
+
+            UbxNavPvtMsg pvt;
+            std::memcpy(&pvt, record.payload, sizeof(pvt));
+            meter.update(pvt);
+        }
+    }
+
+    std::cerr << meter.runs().size() << " runs\n";
+    return EXIT_SUCCESS;
+}
+
+int info(const TrackReader& reader)
+{
+    std::cout << "points: " << reader.pointCount() << "\n"
+              << "blocks: " << reader.blockCount() << "\n"
+              << "start: " << reader.startTime() << "\n"
+              << "end: " << reader.endTime() << "\n"
+              << "recovered: " << (reader.wasRecovered() ? "yes" : "no") << "\n";
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return usage();
+
+    const std::string command = argv[1];
+    if (command == "pack")
+        return pack(argc, argv);
+    if (command == "runs")
+        return runs(argc, argv);
+
+    TrackReader reader(argv[2]);
+    if (!reader.isOpen()) {
+        std::cerr << "cannot read " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (command == "info")
+        return info(reader);
+
+    track::ExportRange range;
+    if (argc > 3)
+        reader.seek(std::strtoll(argv[3], nullptr, 10));
+    if (argc > 4)
+        range.end_time_ms = std::strtoll(argv[4], nullptr, 10);
+
+    if (command == "gpx")
+        track::exportGpx(reader, std::cout, range);
+    else if (command == "csv")
+        track::exportCsv(reader, std::cout, range);
+    else
+        return usage();
+
+    if (reader.badBlocks() > 0U)
+        std::cerr << "skipped " << reader.badBlocks() << " damaged blocks\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,450 @@
+#include "sim_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <QCoreApplication>
+
+#include "devices/ubx_config.h"
+#include "devices/ubx_frame.h"
+
+namespace {
+
+constexpr uint32_t kMillisecondsInWeek{604800000U};
+constexpr int64_t kGpsEpochUnixMs{315964800000LL};
+constexpr int64_t kGpsLeapMs{18000}; // GPS - UTC
+
+constexpr uint16_t kUbxNavSat{0x0135U};
+constexpr uint8_t kCfgClass{0x06U};
+
+// raw clients that send nothing this long get the stream without a GET
+constexpr qint64 kCasterRawAfterMs{500};
+
+// packs fields MSB first, as RTCM does
+class BitWriter {
+public:
+    void put(uint64_t value, size_t bits)
+    {
+        for (size_t i = bits; i-- > 0;) {
+            if (used_ % 8U == 0U)
+                bytes_.push_back(0U);
+            bytes_.back() |= static_cast<uint8_t>(((value >> i) & 1U) << (7U - used_ % 8U));
+            ++used_;
+        }
+    }
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    size_t used_ = 0U;
+};
+
+QByteArray rtcmFrame(const std::vector<uint8_t>& payload)
+{
+    QByteArray frame;
+    frame.append(static_cast<char>(rtcm3::kPreamble));
+    frame.append(static_cast<char>((payload.size() >> 8) & 0x03U));
+    frame.append(static_cast<char>(payload.size() & 0xFFU));
+    frame.append(reinterpret_cast<const char*>(payload.data()), static_cast<qsizetype>(payload.size()));
+    const uint32_t crc = rtcm3::crc24q(reinterpret_cast<const uint8_t*>(frame.data()), static_cast<size_t>(frame.size()));
+    frame.append(static_cast<char>(crc >> 16));
+    frame.append(static_cast<char>(crc >> 8));
+    frame.append(static_cast<char>(crc));
+    return frame;
+}
+
+} // namespace
+
+SimServer::SimServer(const SimOptions& options, std::vector<SimTrajectory::Segment> segments,
+                     QObject* parent)
+    : QObject(parent)
+    , options_(options)
+    , trajectory_(std::move(segments), 47.6062, -122.3321, 60.0)
+    , rng_(options.seed)
+{
+    connect(&server_, &QTcpServer::newConnection, this, &SimServer::onNewConnection);
+
+    tick_.setTimerType(Qt::PreciseTimer);
+    connect(&tick_, &QTimer::timeout, this, &SimServer::onTick);
+
+    report_.setInterval(5000);
+    connect(&report_, &QTimer::timeout, this, &SimServer::onReport);
+
+    setRate(options_.rate_hz);
+}
+
+bool SimServer::listen()
+{
+    if (!server_.listen(QHostAddress::Any, options_.port)) {
+        std::cerr << "listen failed: " << server_.errorString().toStdString() << "\n";
+        return false;
+    }
+
+    if (options_.caster_port != 0U) {
+        connect(&caster_, &QTcpServer::newConnection, this, &SimServer::onNewCasterConnection);
+        if (!caster_.listen(QHostAddress::Any, options_.caster_port)) {
+            std::cerr << "caster listen failed: " << caster_.errorString().toStdString() << "\n";
+            return false;
+        }
+        std::cout << "rtcm caster on port " << options_.caster_port << "\n";
+    }
+
+    start_unix_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    clock_.start();
+    next_stall_s_ = options_.stall_every_s;
+    tick_.start();
+    report_.start();
+
+    std::cout << "simulating '" << options_.scenario.toStdString() << "' at " << options_.rate_hz
+              << " Hz on port " << options_.port << "\n";
+    return true;
+}
+
+void SimServer::setRate(double rate_hz)
+{
+    options_.rate_hz = std::clamp(rate_hz, 0.1, 2000.0);
+    period_s_ = 1.0 / options_.rate_hz;
+    // QTimer resolution is a millisecond; faster rates send several epochs
+    // per tick to keep up
+    tick_.setInterval(std::max(1, static_cast<int>(period_s_ * 1000.0)));
+}
+
+bool SimServer::chance(double probability)
+{
+    return probability > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < probability;
+}
+
+void SimServer::onNewConnection()
+{
+    while (QTcpSocket* socket = server_.nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        auto client = std::make_unique<Client>();
+        client->socket = socket;
+        Client* raw = client.get();
+        client->parser.setFrameHandler([this, raw](MsgClassId id, const uint8_t* frame, size_t length) {
+            handleClientFrame(*raw, id, frame, length);
+        });
+
+        client->rtcm.setFrameHandler([this](const uint8_t*, size_t) { ++rtcm_in_; });
+
+        connect(socket, &QTcpSocket::readyRead, this, [raw] {
+            const QByteArray bytes = raw->socket->readAll();
+            raw->parser.read_bytes(bytes);
+            raw->rtcm.push(reinterpret_cast<const uint8_t*>(bytes.data()), static_cast<size_t>(bytes.size()));
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket] { removeClient(socket); });
+
+        clients_.push_back(std::move(client));
+        std::cout << "client connected from " << socket->peerAddress().toString().toStdString() << "\n";
+    }
+}
+
+void SimServer::onNewCasterConnection()
+{
+    while (QTcpSocket* socket = caster_.nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        auto client = std::make_unique<CasterClient>();
+        client->socket = socket;
+        client->connected.start();
+        CasterClient* raw = client.get();
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, raw] { onCasterData(*raw); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+            caster_clients_.erase(std::remove_if(caster_clients_.begin(), caster_clients_.end(),
+                                                 [socket](const std::unique_ptr<CasterClient>& c) {
+                                                     return c->socket == socket;
+                                                 }),
+                                  caster_clients_.end());
+            socket->deleteLater();
+            std::cout << "caster client disconnected\n";
+        });
+
+        caster_clients_.push_back(std::move(client));
+        std::cout << "caster client connected from " << socket->peerAddress().toString().toStdString() << "\n";
+    }
+}
+
+void SimServer::onCasterData(CasterClient& client)
+{
+    client.request += client.socket->readAll();
+    if (client.streaming || !client.request.contains("\r\n\r\n"))
+        return;
+
+    // any mountpoint will do
+    if (client.request.startsWith("GET ")) {
+        // NTRIP 1.0: the bare status line, the stream follows at once
+        client.socket->write("ICY 200 OK\r\n");
+        client.streaming = true;
+    } else {
+        client.socket->write("HTTP/1.0 400 Bad Request\r\n\r\n");
+        client.socket->disconnectFromHost();
+    }
+}
+
+void SimServer::sendCorrections(uint32_t itow)
+{
+    // 1005: station 1, GPS, at the trajectory's start
+    BitWriter station;
+    station.put(1005U, 12);
+    station.put(1U, 12);
+    station.put(0U, 6);  // ITRF realization year
+    station.put(1U, 1);  // GPS
+    station.put(0U, 3);  // no GLONASS, Galileo, reference station
+    station.put(static_cast<uint64_t>(-23059123456LL) & ((1ULL << 38) - 1U), 38); // ECEF X, 0.1 mm
+    station.put(0U, 2);
+    station.put(static_cast<uint64_t>(-36712345678LL) & ((1ULL << 38) - 1U), 38); // Y
+    station.put(0U, 2);
+    station.put(46908765432ULL, 38); // Z
+    const QByteArray station_frame = rtcmFrame(station.bytes());
+
+    // 1074 with no satellites: only the header, to carry the epoch
+    BitWriter msm;
+    msm.put(1074U, 12);
+    msm.put(1U, 12);
+    msm.put(itow, 30);
+    msm.put(0U, 1 + 3 + 7 + 2 + 2 + 1 + 3);
+    msm.put(0U, 64); // satellite mask
+    msm.put(0U, 32); // signal mask
+    const QByteArray msm_frame = rtcmFrame(msm.bytes());
+
+    for (const auto& client : caster_clients_) {
+        if (!client->streaming && client->request.isEmpty() && client->connected.elapsed() >= kCasterRawAfterMs)
+            client->streaming = true;
+        if (!client->streaming)
+            continue;
+        client->socket->write(station_frame);
+        client->socket->write(msm_frame);
+        rtcm_out_ += 2U;
+    }
+}
+
+void SimServer::removeClient(QTcpSocket* socket)
+{
+    clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                  [socket](const std::unique_ptr<Client>& c) { return c->socket == socket; }),
+                   clients_.end());
+    socket->deleteLater();
+    std::cout << "client disconnected\n";
+}
+
+void SimServer::onTick()
+{
+    const double now = clock_.nsecsElapsed() * 1e-9;
+
+    if (options_.duration_s > 0.0 && now >= options_.duration_s) {
+        onReport();
+        QCoreApplication::quit();
+        return;
+    }
+
+    while (next_epoch_s_ <= now) {
+        generateEpoch();
+        next_epoch_s_ += period_s_;
+    }
+
+    if (options_.stall_every_s > 0.0 && now >= next_stall_s_) {
+        stall_until_s_ = now + options_.stall_ms * 1e-3;
+        next_stall_s_ = now + options_.stall_every_s;
+        ++stalls_;
+    }
+
+    if (now >= stall_until_s_ && pending_epochs_ >= options_.burst_epochs)
+        flushPending();
+}
+
+void SimServer::generateEpoch()
+{
+    trajectory_.step(period_s_);
+    sim_time_s_ += period_s_;
+
+    const int64_t unix_ms = start_unix_ms_ + static_cast<int64_t>(std::llround(sim_time_s_ * 1000.0));
+    const uint32_t itow = static_cast<uint32_t>((unix_ms - kGpsEpochUnixMs + kGpsLeapMs) % kMillisecondsInWeek);
+
+    const UbxNavPvtMsg pvt = trajectory_.navPvt(unix_ms, itow);
+    appendFrame(MsgClassId::kUbxNavPvt, reinterpret_cast<const uint8_t*>(&pvt), sizeof(pvt));
+    const UbxNavHpposllhMsg hp = trajectory_.navHpposllh(itow);
+    appendFrame(MsgClassId::kUbxNavHpposllh, reinterpret_cast<const uint8_t*>(&hp), sizeof(hp));
+
+    if (options_.sat_count > 0) {
+        // NAV-SAT: 8 byte header and 12 bytes per sv; contents do not matter
+        // to the client, it is there to load the link and the parser
+        std::vector<uint8_t> sat(8U + 12U * options_.sat_count, 0U);
+        std::memcpy(sat.data(), &itow, sizeof(itow));
+        sat[4] = 1U;
+        sat[5] = static_cast<uint8_t>(options_.sat_count);
+        for (int i = 0; i < options_.sat_count; ++i) {
+            sat[8 + 12 * i] = static_cast<uint8_t>(i % 7);
+            sat[9 + 12 * i] = static_cast<uint8_t>(i + 1);
+            sat[10 + 12 * i] = 40U;
+        }
+        appendFrame(static_cast<MsgClassId>(kUbxNavSat), sat.data(), sat.size());
+    }
+
+    if (!caster_clients_.empty() && itow / 1000U != last_rtcm_second_) {
+        last_rtcm_second_ = itow / 1000U;
+        sendCorrections(itow);
+    }
+
+    ++epochs_;
+    ++pending_epochs_;
+}
+
+void SimServer::appendFrame(MsgClassId id, const uint8_t* payload, size_t length)
+{
+    if (chance(options_.garbage_rate)) {
+        const int n = std::uniform_int_distribution<int>(1, 64)(rng_);
+        for (int i = 0; i < n; ++i)
+            pending_.append(static_cast<char>(rng_()));
+    }
+
+    std::vector<uint8_t> frame = ubx::buildFrame(id, payload, length);
+    if (chance(options_.corrupt_rate)) {
+        frame[frame.size() - 1 - (rng_() & 1U)] ^= 0x5AU;
+        ++corrupted_;
+    }
+
+    pending_.append(reinterpret_cast<const char*>(frame.data()), static_cast<qsizetype>(frame.size()));
+    ++frames_;
+}
+
+void SimServer::flushPending()
+{
+    if (pending_.isEmpty())
+        return;
+
+    for (const auto& client : clients_)
+        writeToClient(*client, pending_);
+
+    bytes_ += static_cast<uint64_t>(pending_.size());
+    pending_.clear();
+    pending_epochs_ = 0;
+}
+
+void SimServer::writeToClient(Client& client, const QByteArray& bytes)
+{
+    if (!options_.split_frames) {
+        client.socket->write(bytes);
+        return;
+    }
+
+    // separate small writes with Nagle off, so the client sees frames cut at
+    // arbitrary points across reads
+    qsizetype offset = 0;
+    while (offset < bytes.size()) {
+        const qsizetype n = std::min<qsizetype>(bytes.size() - offset,
+                                                std::uniform_int_distribution<int>(1, 48)(rng_));
+        client.socket->write(bytes.constData() + offset, n);
+        client.socket->flush();
+        offset += n;
+    }
+}
+
+void SimServer::handleClientFrame(Client& client, MsgClassId id, const uint8_t* frame, size_t length)
+{
+    const uint16_t msg = static_cast<uint16_t>(id);
+    if ((msg >> 8) != kCfgClass)
+        return;
+
+    ++cfg_requests_;
+    if (chance(options_.ack_drop_rate))
+        return;
+
+    const uint8_t* payload = frame + UbloxParser::kHeaderSize;
+    const size_t payload_length = length - UbloxParser::kFrameOverhead;
+    const std::vector<uint8_t> ack{static_cast<uint8_t>(msg >> 8), static_cast<uint8_t>(msg & 0xFFU)};
+
+    if (chance(options_.nak_rate)) {
+        reply(client, MsgClassId::kUbxAckNak, ack);
+        return;
+    }
+
+    if (id == MsgClassId::kUbxCfgValset && payload_length >= 4U) {
+        const uint8_t layers = payload[1];
+        size_t offset = 4U;
+        while (offset + 4U <= payload_length) {
+            uint32_t key;
+            std::memcpy(&key, payload + offset, sizeof(key));
+            const size_t size = ubx::cfg::valueSize(key);
+            offset += 4U;
+            if (size == 0U || offset + size > payload_length)
+                break;
+
+            uint64_t value = 0U;
+            std::memcpy(&value, payload + offset, size);
+            for (size_t layer = 0; layer < cfg_layers_.size(); ++layer) {
+                if (layers & (1U << layer))
+                    cfg_layers_[layer][key] = value;
+            }
+            offset += size;
+
+            // only RAM is the running configuration
+            const bool ram = layers & static_cast<uint8_t>(ubx::cfg::Layer::kRam);
+            if (ram && key == ubx::cfg::key::kRateMeas && options_.follow_cfg_rate && value > 0U) {
+                setRate(1000.0 / static_cast<double>(value));
+                std::cout << "rate set to " << options_.rate_hz << " Hz by CFG-VALSET\n";
+            }
+        }
+    } else if (id == MsgClassId::kUbxCfgValget && payload_length >= 4U) {
+        // like the receiver: a layer number, not the VALSET bitmask; RAM and
+        // the defaults know every key, BBR and flash only what was stored
+        const uint8_t layer = payload[1];
+        const bool stored = layer == static_cast<uint8_t>(ubx::cfg::ValgetLayer::kBbr) ||
+                            layer == static_cast<uint8_t>(ubx::cfg::ValgetLayer::kFlash);
+        if (layer != static_cast<uint8_t>(ubx::cfg::ValgetLayer::kRam) && !stored &&
+            layer != static_cast<uint8_t>(ubx::cfg::ValgetLayer::kDefault)) {
+            reply(client, MsgClassId::kUbxAckNak, ack);
+            return;
+        }
+
+        std::vector<ubx::cfg::KeyValue> values;
+        for (size_t offset = 4U; offset + 4U <= payload_length; offset += 4U) {
+            uint32_t key;
+            std::memcpy(&key, payload + offset, sizeof(key));
+            if (layer == static_cast<uint8_t>(ubx::cfg::ValgetLayer::kDefault)) {
+                values.push_back({key, 0U});
+                continue;
+            }
+            const std::map<uint32_t, uint64_t>& layer_values = cfg_layers_[layer];
+            const auto it = layer_values.find(key);
+            if (it == layer_values.end() && stored) {
+                reply(client, MsgClassId::kUbxAckNak, ack);
+                return;
+            }
+            values.push_back({key, it == layer_values.end() ? 0U : it->second});
+        }
+
+        // a VALGET response has the VALSET layout with version 1
+        std::vector<uint8_t> response = ubx::cfg::encodeValset(values, payload[1]);
+        response[0] = 0x01U;
+        reply(client, MsgClassId::kUbxCfgValget, response);
+    }
+
+    reply(client, MsgClassId::kUbxAckAck, ack);
+}
+
+void SimServer::reply(Client& client, MsgClassId id, const std::vector<uint8_t>& payload)
+{
+    const std::vector<uint8_t> frame = ubx::buildFrame(id, payload);
+    client.socket->write(reinterpret_cast<const char*>(frame.data()), static_cast<qsizetype>(frame.size()));
+}
+
+void SimServer::onReport()
+{
+    const double seconds = report_.interval() * 1e-3;
+    std::cout << "clients " << clients_.size() << "  epochs/s " << epochs_ / seconds << "  frames "
+              << frames_ << "  KiB/s " << bytes_ / seconds / 1024.0 << "  corrupted " << corrupted_
+              << "  stalls " << stalls_ << "  cfg " << cfg_requests_ << "  speed "
+              << trajectory_.speed() << " m/s" << (trajectory_.hasFix() ? "" : " (no fix)");
+    if (options_.caster_port != 0U)
+        std::cout << "  rtcm out " << rtcm_out_ << " in " << rtcm_in_;
+    std::cout << "\n";
+
+    epochs_ = frames_ = bytes_ = corrupted_ = stalls_ = cfg_requests_ = rtcm_out_ = rtcm_in_ = 0U;
+}
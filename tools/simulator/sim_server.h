@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "devices/rtcm3_framer.h"
+#include "devices/ublox_parser.h"
+#include "sim_trajectory.h"
+
+struct SimOptions {
+    quint16 port = 8100;
+    double rate_hz = 10.0;
+    bool follow_cfg_rate = true; // let CFG-RATE-MEAS from the client change rate_hz
+    QString scenario = "mixed";
+
+    // fault injection, rates are per frame
+    double corrupt_rate = 0.0; // flip a checksum byte
+    double garbage_rate = 0.0; // random noise before the frame
+    bool split_frames = false; // write every frame in random small pieces
+    int burst_epochs = 1;      // epochs held back and written together
+    double stall_every_s = 0.0; // 0 disables stalls
+    int stall_ms = 0;          // output held during a stall, then released at once
+    int sat_count = 0;         // svs in a NAV-SAT sent after each NAV-PVT, 0 disables
+    double nak_rate = 0.0;     // answer CFG with ACK-NAK
+    double ack_drop_rate = 0.0; // do not answer CFG at all
+
+    // a stand-in RTCM caster: a station message and an empty GPS MSM every
+    // second, raw or behind an NTRIP GET; 0 disables
+    quint16 caster_port = 0;
+
+    uint32_t seed = 1U;
+    double duration_s = 0.0; // 0 runs forever
+};
+
+// Serves a simulated u-blox stream to any number of TCP clients and answers
+// their CFG messages.
+class SimServer final : public QObject
+{
+    Q_OBJECT
+public:
+    SimServer(const SimOptions& options, std::vector<SimTrajectory::Segment> segments,
+              QObject* parent = nullptr);
+
+    bool listen();
+
+private slots:
+    void onNewConnection();
+    void onNewCasterConnection();
+    void onTick();
+    void onReport();
+
+private:
+    struct Client {
+        QTcpSocket* socket = nullptr;
+        UbloxParser parser;
+        Rtcm3Framer rtcm; // corrections the client relays to the receiver
+    };
+
+    struct CasterClient {
+        QTcpSocket* socket = nullptr;
+        QByteArray request;
+        bool streaming = false; // NTRIP answered, or a raw client that stayed quiet
+        QElapsedTimer connected;
+    };
+
+    SimOptions options_;
+    SimTrajectory trajectory_;
+    std::mt19937 rng_;
+
+    QTcpServer server_;
+    std::vector<std::unique_ptr<Client>> clients_;
+    QTcpServer caster_;
+    std::vector<std::unique_ptr<CasterClient>> caster_clients_;
+    uint32_t last_rtcm_second_ = UINT32_MAX;
+    QTimer tick_;
+    QTimer report_;
+    QElapsedTimer clock_;
+
+    int64_t start_unix_ms_ = 0;
+    double period_s_ = 0.1;
+    double next_epoch_s_ = 0.0;
+    double sim_time_s_ = 0.0;
+    double next_stall_s_ = 0.0;
+    double stall_until_s_ = 0.0;
+
+    QByteArray pending_;
+    int pending_epochs_ = 0;
+
+    // what CFG-VALSET wrote, per layer: RAM, BBR, flash (VALGET numbering)
+    std::array<std::map<uint32_t, uint64_t>, 3> cfg_layers_;
+
+    // counters since the last report
+    uint64_t epochs_ = 0U;
+    uint64_t frames_ = 0U;
+    uint64_t bytes_ = 0U;
+    uint64_t corrupted_ = 0U;
+    uint64_t stalls_ = 0U;
+    uint64_t cfg_requests_ = 0U;
+    uint64_t rtcm_out_ = 0U; // frames sent by the caster
+    uint64_t rtcm_in_ = 0U;  // frames relayed back by clients
+
+    bool chance(double probability);
+    void setRate(double rate_hz);
+    void generateEpoch();
+    void appendFrame(MsgClassId id, const uint8_t* payload, size_t length);
+    void flushPending();
+    void writeToClient(Client& client, const QByteArray& bytes);
+    void handleClientFrame(Client& client, MsgClassId id, const uint8_t* frame, size_t length);
+    void reply(Client& client, MsgClassId id, const std::vector<uint8_t>& payload);
+    void removeClient(QTcpSocket* socket);
+    void sendCorrections(uint32_t itow);
+    void onCasterData(CasterClient& client);
+};
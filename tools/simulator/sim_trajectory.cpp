@@ -0,0 +1,186 @@
+#include "sim_trajectory.h"
+
+#include <chrono>
+#include <cmath>
+
+#include <boost/math/constants/constants.hpp>
+
+namespace {
+
+constexpr double kDegToRad = boost::math::constants::pi<double>() / 180.0;
+constexpr double kEarthRadius = 6378137.0;
+
+} // namespace
+
+bool SimTrajectory::scenario(const std::string& name, std::vector<Segment>& segments)
+{
+    using K = SegmentKind;
+
+    // a ~300 m circle at 20 m/s
+    const std::vector<Segment> loop{{K::kAccel, 8.0, 20.0, 0.0}, {K::kCruise, 94.0, 0.0, 3.82}};
+    const std::vector<Segment> stops{{K::kAccel, 6.0, 15.0, 0.0},  {K::kCruise, 20.0, 0.0, 0.0},
+                                     {K::kAccel, 5.0, 0.0, 0.0},   {K::kStop, 10.0, 0.0, 0.0},
+                                     {K::kAccel, 4.0, 25.0, 0.0},  {K::kCruise, 15.0, 0.0, 6.0},
+                                     {K::kAccel, 6.0, 0.0, 0.0},   {K::kStop, 30.0, 0.0, 0.0}};
+    const std::vector<Segment> tunnel{{K::kAccel, 6.0, 22.0, 0.0}, {K::kCruise, 30.0, 0.0, 0.0},
+                                      {K::kTunnel, 15.0, 0.0, 0.0}, {K::kCruise, 30.0, 0.0, 2.0},
+                                      {K::kTunnel, 45.0, 0.0, 0.0}, {K::kAccel, 6.0, 0.0, 0.0},
+                                      {K::kStop, 5.0, 0.0, 0.0}};
+
+    if (name == "loop")
+        segments = loop;
+    else if (name == "stops")
+        segments = stops;
+    else if (name == "tunnel")
+        segments = tunnel;
+    else if (name == "mixed") {
+        segments = loop;
+        segments.insert(segments.end(), stops.begin(), stops.end());
+        segments.insert(segments.end(), tunnel.begin(), tunnel.end());
+    } else
+        return false;
+
+    return true;
+}
+
+SimTrajectory::SimTrajectory(std::vector<Segment> segments, double origin_lat, double origin_lon,
+                             double height_m)
+    : segments_(std::move(segments))
+    , origin_lat_(origin_lat)
+    , origin_lon_(origin_lon)
+    , height_(height_m)
+{
+}
+
+void SimTrajectory::step(double dt_s)
+{
+    if (segments_.empty())
+        return;
+
+    const Segment* segment = &segments_[segment_];
+    segment_time_ += dt_s;
+    if (segment_time_ >= segment->duration_s) {
+        segment_time_ -= segment->duration_s;
+        segment_ = (segment_ + 1) % segments_.size();
+        segment = &segments_[segment_];
+        segment_start_speed_ = speed_;
+    }
+
+    switch (segment->kind) {
+    case SegmentKind::kAccel: {
+        const double fraction = std::min(1.0, segment_time_ / segment->duration_s);
+        speed_ = segment_start_speed_ + (segment->target_speed_mps - segment_start_speed_) * fraction;
+    } break;
+    case SegmentKind::kStop:
+        speed_ = 0.0;
+        break;
+    case SegmentKind::kCruise:
+    case SegmentKind::kTunnel:
+        heading_deg_ = std::fmod(heading_deg_ + segment->turn_rate_dps * dt_s + 360.0, 360.0);
+        break;
+    }
+
+    has_fix_ = segment->kind != SegmentKind::kTunnel;
+    north_ += speed_ * std::cos(heading_deg_ * kDegToRad) * dt_s;
+    east_ += speed_ * std::sin(heading_deg_ * kDegToRad) * dt_s;
+}
+
+double SimTrajectory::latitude() const
+{
+    return origin_lat_ + north_ / kEarthRadius / kDegToRad;
+}
+
+double SimTrajectory::longitude() const
+{
+    return origin_lon_ + east_ / (kEarthRadius * std::cos(origin_lat_ * kDegToRad)) / kDegToRad;
+}
+
+UbxNavPvtMsg SimTrajectory::navPvt(int64_t unix_ms, uint32_t itow_ms) const
+{
+    using namespace std::chrono;
+
+    const sys_time<milliseconds> t{milliseconds{unix_ms}};
+    const sys_days day = floor<days>(t);
+    const year_month_day ymd{day};
+    const hh_mm_ss<milliseconds> tod{t - day};
+
+    const double lat = latitude();
+    const double lon = longitude();
+    const double vn = speed_ * std::cos(heading_deg_ * kDegToRad);
+    const double ve = speed_ * std::sin(heading_deg_ * kDegToRad);
+
+    UbxNavPvtMsg m{};
+    m.itow = itow_ms;
+    m.year = static_cast<uint16_t>(static_cast<int>(ymd.year()));
+    m.month = static_cast<uint8_t>(static_cast<unsigned>(ymd.month()));
+    m.day = static_cast<uint8_t>(static_cast<unsigned>(ymd.day()));
+    m.hour = static_cast<uint8_t>(tod.hours().count());
+    m.min = static_cast<uint8_t>(tod.minutes().count());
+    m.sec = static_cast<uint8_t>(tod.seconds().count());
+    m.nano = static_cast<int32_t>(tod.subseconds().count() * 1000000);
+    m.valid = 0x07U; // date, time, fully resolved
+    m.time_accuracy = 30U;
+
+    m.fix_type = has_fix_ ? 3U : 0U;
+    m.flags.word = 0U;
+    m.flags.gnss_fix_ok = has_fix_ ? 1U : 0U;
+    m.flags.head_veh_valid = 0U;
+    m.num_sv = has_fix_ ? 18U : 0U;
+
+    m.lat = static_cast<int32_t>(std::lround(lat * 1e7));
+    m.lon = static_cast<int32_t>(std::lround(lon * 1e7));
+    m.height = static_cast<int32_t>(std::lround((height_ + 20.0) * 1e3));
+    m.height_msl = static_cast<int32_t>(std::lround(height_ * 1e3));
+    m.horizontal_acc = has_fix_ ? 900U : 50000U;
+    m.vertical_acc = has_fix_ ? 1500U : 80000U;
+
+    m.velocity_n = static_cast<int32_t>(std::lround(vn * 1e3));
+    m.velocity_e = static_cast<int32_t>(std::lround(ve * 1e3));
+    m.velocity_d = 0;
+    m.ground_speed = static_cast<int32_t>(std::lround(speed_ * 1e3));
+    m.heading_motion = static_cast<int32_t>(std::lround(heading_deg_ * 1e5));
+    m.speed_acc = has_fix_ ? 150U : 5000U;
+    m.heading_acc = static_cast<uint32_t>(speed_ > 1.0 ? 50000U : 18000000U);
+    m.position_dop = 120U;
+    m.flags3.word = 0U;
+    m.reserved = {};
+    m.heading_vehicle = 0;
+    m.magnetic_declination = 0;
+    m.magnetic_declination_acc = 0U;
+    return m;
+}
+
+UbxNavHpposllhMsg SimTrajectory::navHpposllh(uint32_t itow_ms) const
+{
+    // split into the 1e-7 base and a residual with the same sign, as the
+    // receiver does
+    const auto split = [](double degrees, int32_t& base, int8_t& hp) {
+        const int64_t total = std::llround(degrees * 1e9);
+        base = static_cast<int32_t>(total / 100);
+        hp = static_cast<int8_t>(total % 100);
+    };
+
+    UbxNavHpposllhMsg m{};
+    m.itow = itow_ms;
+    m.flags.invalid_llh = has_fix_ ? 0U : 1U;
+
+    int32_t base{};
+    split(latitude(), base, m.lat_hp);
+    m.lat = base;
+    split(longitude(), base, m.lon_hp);
+    m.lon = base;
+
+    const auto split_height = [](double meters, int32_t& mm, int8_t& hp) {
+        const int64_t total = std::llround(meters * 1e4);
+        mm = static_cast<int32_t>(total / 10);
+        hp = static_cast<int8_t>(total % 10);
+    };
+    split_height(height_ + 20.0, base, m.height_hp);
+    m.height = base;
+    split_height(height_, base, m.height_msl_hp);
+    m.height_msl = base;
+
+    m.horizontal_acc = has_fix_ ? 9000U : 500000U;
+    m.vertical_acc = has_fix_ ? 15000U : 800000U;
+    return m;
+}
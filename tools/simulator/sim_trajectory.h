@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "devices/ubx_types.h"
+
+// Scripted vehicle motion for the simulator. A scenario is a list of
+// segments that repeats forever; the trajectory is integrated in a local
+// north/east frame around a fixed origin.
+class SimTrajectory {
+    public:
+    enum class SegmentKind : uint8_t {
+        kCruise, // hold speed, turning at turn_rate
+        kAccel,  // change speed linearly to target_speed over the duration
+        kStop,   // stationary
+        kTunnel, // keep driving with no fix
+    };
+
+    struct Segment {
+        SegmentKind kind;
+        double duration_s;
+        double target_speed_mps; // kAccel
+        double turn_rate_dps;    // kCruise, kTunnel
+    };
+
+    // "loop", "stops", "tunnel" or "mixed"; false for an unknown name
+    static bool scenario(const std::string& name, std::vector<Segment>& segments);
+
+    SimTrajectory(std::vector<Segment> segments, double origin_lat, double origin_lon, double height_m);
+
+    void step(double dt_s);
+
+    // receiver time of the current state, GPS time of week and UTC
+    UbxNavPvtMsg navPvt(int64_t unix_ms, uint32_t itow_ms) const;
+    UbxNavHpposllhMsg navHpposllh(uint32_t itow_ms) const;
+
+    bool hasFix() const { return has_fix_; }
+    double speed() const { return speed_; }
+
+    private:
+    double latitude() const;
+    double longitude() const;
+
+    std::vector<Segment> segments_;
+    size_t segment_{};
+    double segment_time_{};
+    double segment_start_speed_{};
+
+    double origin_lat_;
+    double origin_lon_;
+    double height_;
+
+    double north_{};
+    double east_{};
+    double speed_{};
+    double heading_deg_{};
+    bool has_fix_{true};
+};
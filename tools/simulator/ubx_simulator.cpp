@@ -0,0 +1,77 @@
+// motohud-sim: a local stand-in for the networked u-blox receiver.
+//
+// Streams NAV-PVT (and optionally NAV-SAT) from a scripted trajectory to
+// every TCP client, answers CFG-VALSET/VALGET with ACKs, and can inject
+// corrupted checksums, noise, split frames, bursts and stalls. Point the
+// HUD at it with `motohud --host 127.0.0.1 --port 8100`. With --caster-port
+// it also stands in for an RTCM caster (`motohud --rtcm 127.0.0.1:2101/SIM`)
+// and counts the corrections the HUD relays back.
+
+#include <iostream>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include "sim_server.h"
+#include "sim_trajectory.h"
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("motohud-sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulated u-blox receiver for load and soak testing");
+    parser.addHelpOption();
+
+    const QCommandLineOption port({"p", "port"}, "TCP port to listen on.", "port", "8100");
+    const QCommandLineOption rate({"r", "rate"}, "Navigation rate in Hz.", "hz", "10");
+    const QCommandLineOption fixed_rate("fixed-rate", "Ignore CFG-RATE-MEAS from clients.");
+    const QCommandLineOption scenario({"s", "scenario"}, "loop, stops, tunnel or mixed.", "name", "mixed");
+    const QCommandLineOption corrupt("corrupt", "Fraction of frames with a bad checksum.", "rate", "0");
+    const QCommandLineOption garbage("garbage", "Fraction of frames preceded by noise.", "rate", "0");
+    const QCommandLineOption split("split", "Write frames in random small pieces.");
+    const QCommandLineOption burst("burst", "Epochs held back and sent together.", "n", "1");
+    const QCommandLineOption stall_every("stall-every", "Seconds between output stalls.", "s", "0");
+    const QCommandLineOption stall_ms("stall-ms", "Length of each stall.", "ms", "0");
+    const QCommandLineOption sats("sats", "Satellites in a NAV-SAT after each epoch.", "n", "0");
+    const QCommandLineOption nak("nak", "Fraction of CFG requests answered with NAK.", "rate", "0");
+    const QCommandLineOption drop_ack("drop-ack", "Fraction of CFG requests not answered.", "rate", "0");
+    const QCommandLineOption caster_port("caster-port", "Serve RTCM corrections on this port.", "port", "0");
+    const QCommandLineOption seed("seed", "Random seed.", "n", "1");
+    const QCommandLineOption duration("duration", "Stop after this many seconds.", "s", "0");
+
+    parser.addOptions({port, rate, fixed_rate, scenario, corrupt, garbage, split, burst, stall_every,
+                       stall_ms, sats, nak, drop_ack, caster_port, seed, duration});
+    parser.process(app);
+
+    SimOptions options;
+    options.port = static_cast<quint16>(parser.value(port).toUInt());
+    options.rate_hz = parser.value(rate).toDouble();
+    options.follow_cfg_rate = !parser.isSet(fixed_rate);
+    options.scenario = parser.value(scenario);
+    options.corrupt_rate = parser.value(corrupt).toDouble();
+    options.garbage_rate = parser.value(garbage).toDouble();
+    options.split_frames = parser.isSet(split);
+    options.burst_epochs = std::max(1, parser.value(burst).toInt());
+    options.stall_every_s = parser.value(stall_every).toDouble();
+    options.stall_ms = parser.value(stall_ms).toInt();
+    options.sat_count = std::clamp(parser.value(sats).toInt(), 0, 52);
+    options.nak_rate = parser.value(nak).toDouble();
+    options.ack_drop_rate = parser.value(drop_ack).toDouble();
+    options.caster_port = static_cast<quint16>(parser.value(caster_port).toUInt());
+    options.seed = parser.value(seed).toUInt();
+    options.duration_s = parser.value(duration).toDouble();
+
+    std::vector<SimTrajectory::Segment> segments;
+    if (!SimTrajectory::scenario(options.scenario.toStdString(), segments)) {
+        std::cerr << "unknown scenario: " << options.scenario.toStdString() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    SimServer server(options, std::move(segments));
+    if (!server.listen())
+        return EXIT_FAILURE;
+
+    return app.exec();
+}
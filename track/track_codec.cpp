@@ -0,0 +1,104 @@
+#include "track_codec.h"
+
+#include <array>
+
+namespace track::codec {
+
+namespace {
+
+using Columns = std::array<int64_t, kColumnCount>;
+
+Columns toColumns(const TrackPoint& p)
+{
+    return {p.time_ms,        p.lat,           p.lon,          p.height_msl, p.height,
+            p.velocity_n,     p.velocity_e,    p.velocity_d,   p.ground_speed,
+            p.heading,        p.horizontal_acc, p.vertical_acc, p.num_sv,
+            p.fix_type,       p.flags};
+}
+
+void setColumn(TrackPoint& p, size_t column, int64_t v)
+{
+    switch (column) {
+    case 0: p.time_ms = v; break;
+    case 1: p.lat = static_cast<int32_t>(v); break;
+    case 2: p.lon = static_cast<int32_t>(v); break;
+    case 3: p.height_msl = static_cast<int32_t>(v); break;
+    case 4: p.height = static_cast<int32_t>(v); break;
+    case 5: p.velocity_n = static_cast<int32_t>(v); break;
+    case 6: p.velocity_e = static_cast<int32_t>(v); break;
+    case 7: p.velocity_d = static_cast<int32_t>(v); break;
+    case 8: p.ground_speed = static_cast<int32_t>(v); break;
+    case 9: p.heading = static_cast<int32_t>(v); break;
+    case 10: p.horizontal_acc = static_cast<uint32_t>(v); break;
+    case 11: p.vertical_acc = static_cast<uint32_t>(v); break;
+    case 12: p.num_sv = static_cast<uint8_t>(v); break;
+    case 13: p.fix_type = static_cast<uint8_t>(v); break;
+    case 14: p.flags = static_cast<uint8_t>(v); break;
+    }
+}
+
+uint64_t zigzag(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1U);
+}
+
+void putVarint(uint64_t v, std::vector<uint8_t>& out)
+{
+    while (v >= 0x80U) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80U);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& v)
+{
+    v = 0U;
+    for (unsigned shift = 0U; shift < 64U && data < end; shift += 7U) {
+        const uint8_t b = *data++;
+        v |= static_cast<uint64_t>(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0U)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void encodeColumns(const TrackPoint* points, size_t count, std::vector<uint8_t>& out)
+{
+    std::vector<Columns> rows(count);
+    for (size_t i = 0; i < count; ++i)
+        rows[i] = toColumns(points[i]);
+
+    for (size_t c = 0; c < kColumnCount; ++c) {
+        int64_t previous = 0;
+        for (size_t i = 0; i < count; ++i) {
+            putVarint(zigzag(rows[i][c] - previous), out);
+            previous = rows[i][c];
+        }
+    }
+}
+
+bool decodeColumns(const uint8_t* data, size_t size, size_t count, TrackPoint* points)
+{
+    const uint8_t* end = data + size;
+    for (size_t c = 0; c < kColumnCount; ++c) {
+        int64_t value = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t raw;
+            if (!getVarint(data, end, raw))
+                return false;
+            value += unzigzag(raw);
+            setColumn(points[i], c, value);
+        }
+    }
+    return data == end;
+}
+
+} // namespace track::codec
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "track_format.h"
+
+// Column transform shared by the track writer and reader. Not part of the
+// public track API.
+namespace track::codec {
+
+// appends the varint column data for `count` points to `out`
+void encodeColumns(const TrackPoint* points, size_t count, std::vector<uint8_t>& out);
+
+// decodes `count` points; false if the data is short or malformed
+bool decodeColumns(const uint8_t* data, size_t size, size_t count, TrackPoint* points);
+
+} // namespace track::codec
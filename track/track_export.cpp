@@ -0,0 +1,67 @@
+#include "track_export.h"
+
+#include "track_reader.h"
+
+#include <cstdio>
+#include <ctime>
+
+namespace track {
+
+namespace {
+
+// ISO 8601 UTC with milliseconds
+void formatTime(int64_t time_ms, char (&out)[32])
+{
+    const std::time_t seconds = static_cast<std::time_t>(time_ms / 1000);
+    std::tm utc{};
+    ::gmtime_r(&seconds, &utc);
+    const size_t n = std::strftime(out, sizeof(out), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(out + n, sizeof(out) - n, ".%03dZ", static_cast<int>(time_ms % 1000));
+}
+
+} // namespace
+
+uint64_t exportGpx(TrackReader& reader, std::ostream& out, ExportRange range)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           "<gpx version=\"1.1\" creator=\"motohud\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+           "<trk><trkseg>\n";
+
+    uint64_t count = 0U;
+    TrackPoint p;
+    char time[32];
+    char line[256];
+    while (reader.next(p) && p.time_ms <= range.end_time_ms) {
+        formatTime(p.time_ms, time);
+        std::snprintf(line, sizeof(line),
+                      "<trkpt lat=\"%.7f\" lon=\"%.7f\"><ele>%.3f</ele><time>%s</time><sat>%u</sat></trkpt>\n",
+                      p.lat * 1e-7, p.lon * 1e-7, p.height_msl * 1e-3, time, p.num_sv);
+        out << line;
+        ++count;
+    }
+
+    out << "</trkseg></trk>\n</gpx>\n";
+    return count;
+}
+
+uint64_t exportCsv(TrackReader& reader, std::ostream& out, ExportRange range)
+{
+    out << "time,lat,lon,height_msl_m,speed_mps,heading_deg,velocity_d_mps,h_acc_m,num_sv,fix_type\n";
+
+    uint64_t count = 0U;
+    TrackPoint p;
+    char time[32];
+    char line[256];
+    while (reader.next(p) && p.time_ms <= range.end_time_ms) {
+        formatTime(p.time_ms, time);
+        std::snprintf(line, sizeof(line), "%s,%.7f,%.7f,%.3f,%.3f,%.5f,%.3f,%.3f,%u,%u\n", time,
+                      p.lat * 1e-7, p.lon * 1e-7, p.height_msl * 1e-3, p.ground_speed * 1e-3,
+                      p.heading * 1e-5, p.velocity_d * 1e-3, p.horizontal_acc * 1e-3, p.num_sv,
+                      p.fix_type);
+        out << line;
+        ++count;
+    }
+    return count;
+}
+
+} // namespace track
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+class TrackReader;
+
+// Streaming converters. Both pull samples from the reader's cursor one at a
+// time, so memory use does not depend on track length. Call
+// TrackReader::seek first to start part way through a track.
+namespace track {
+
+struct ExportRange {
+    int64_t end_time_ms{std::numeric_limits<int64_t>::max()};
+};
+
+uint64_t exportGpx(TrackReader& reader, std::ostream& out, ExportRange range = {});
+uint64_t exportCsv(TrackReader& reader, std::ostream& out, ExportRange range = {});
+
+} // namespace track
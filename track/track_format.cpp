@@ -0,0 +1,36 @@
+#include "track_format.h"
+
+#include <chrono>
+
+namespace track {
+
+TrackPoint fromNavPvt(const UbxNavPvtMsg& pvt)
+{
+    using namespace std::chrono;
+
+    const sys_days day = year_month_day{year{pvt.year.value()}, month{pvt.month}, std::chrono::day{pvt.day}};
+    const auto t = day + hours{pvt.hour} + minutes{pvt.min} + seconds{pvt.sec};
+    // nano is signed and may pull the time back into the previous second
+    const int64_t time_ms = duration_cast<milliseconds>(t.time_since_epoch()).count() +
+                            pvt.nano.value() / 1000000;
+
+    TrackPoint p{};
+    p.time_ms = time_ms;
+    p.lat = pvt.lat.value();
+    p.lon = pvt.lon.value();
+    p.height_msl = pvt.height_msl.value();
+    p.height = pvt.height.value();
+    p.velocity_n = pvt.velocity_n.value();
+    p.velocity_e = pvt.velocity_e.value();
+    p.velocity_d = pvt.velocity_d.value();
+    p.ground_speed = pvt.ground_speed.value();
+    p.heading = pvt.heading_motion.value();
+    p.horizontal_acc = pvt.horizontal_acc.value();
+    p.vertical_acc = pvt.vertical_acc.value();
+    p.num_sv = pvt.num_sv;
+    p.fix_type = pvt.fix_type;
+    p.flags = pvt.flags.word;
+    return p;
+}
+
+} // namespace track
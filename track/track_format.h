@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "devices/ubx_types.h"
+
+// Compact columnar track file (.mht).
+//
+//   FileHeader
+//   BlockHeader + deflated column data   (repeated)
+//   IndexEntry[block_count]              (one per block, sorted by time)
+//   Footer
+//
+// A block holds up to block_points samples. Inside a block every column is
+// stored contiguously as zigzag varints of the difference to the previous
+// sample (the first sample is a difference to zero), and the whole column
+// area is deflated on its own, so any block decodes without its neighbours.
+// The footer is written last; a file cut off before it is still readable by
+// walking the block headers.
+
+namespace track {
+
+static constexpr uint32_t kFileMagic{0x3154484DU};   // "MHT1"
+static constexpr uint32_t kBlockMagic{0x4B4C4254U};  // "TBLK"
+static constexpr uint32_t kFooterMagic{0x58444E49U}; // "INDX"
+static constexpr uint16_t kFormatVersion{1U};
+static constexpr uint32_t kDefaultBlockPoints{256U};
+static constexpr const char* kFileExtension{".mht"};
+
+// one sample, all integers in receiver units so encoding is lossless
+struct TrackPoint {
+    int64_t time_ms;        // UTC, milliseconds since the unix epoch
+    int32_t lat;            // 1e-7 degrees
+    int32_t lon;            // 1e-7 degrees
+    int32_t height_msl;     // mm
+    int32_t height;         // mm above ellipsoid
+    int32_t velocity_n;     // mm/s
+    int32_t velocity_e;     // mm/s
+    int32_t velocity_d;     // mm/s
+    int32_t ground_speed;   // mm/s
+    int32_t heading;        // 1e-5 degrees, heading of motion
+    uint32_t horizontal_acc; // mm
+    uint32_t vertical_acc;   // mm
+    uint8_t num_sv;
+    uint8_t fix_type;
+    uint8_t flags;
+};
+
+static constexpr size_t kColumnCount{15U};
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t column_count;
+    uint32_t block_points;
+    uint32_t reserved;
+};
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t point_count;
+    int64_t first_time_ms;
+    int64_t last_time_ms;
+    uint32_t raw_size;        // varint column bytes before deflate
+    uint32_t compressed_size; // bytes following this header
+    uint32_t crc;             // crc32 of the compressed bytes
+    uint32_t reserved;
+};
+
+struct IndexEntry {
+    int64_t first_time_ms;
+    int64_t last_time_ms;
+    uint64_t offset; // of the BlockHeader
+    uint32_t point_count;
+    uint32_t reserved;
+};
+
+struct Footer {
+    uint64_t index_offset;
+    uint64_t point_count;
+    uint32_t block_count;
+    uint32_t magic;
+};
+
+TrackPoint fromNavPvt(const UbxNavPvtMsg& pvt);
+
+} // namespace track
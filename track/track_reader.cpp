@@ -0,0 +1,174 @@
+#include "track_reader.h"
+
+#include "track_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <boost/crc.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+TrackReader::TrackReader(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(track::FileHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return;
+
+    track::FileHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    if (header.magic != track::kFileMagic || header.column_count != track::kColumnCount) {
+        ::munmap(map, st.st_size);
+        return;
+    }
+
+    data_ = static_cast<const uint8_t*>(map);
+    size_ = static_cast<size_t>(st.st_size);
+
+    if (!loadIndex())
+        scanBlocks();
+}
+
+TrackReader::~TrackReader()
+{
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+int64_t TrackReader::startTime() const
+{
+    return index_.empty() ? 0 : index_.front().first_time_ms;
+}
+
+int64_t TrackReader::endTime() const
+{
+    return index_.empty() ? 0 : index_.back().last_time_ms;
+}
+
+bool TrackReader::seek(int64_t time_ms)
+{
+    // first block whose last sample is not before the target
+    const auto it = std::lower_bound(index_.begin(), index_.end(), time_ms,
+                                     [](const track::IndexEntry& e, int64_t t) { return e.last_time_ms < t; });
+    if (it == index_.end()) {
+        block_ = index_.size();
+        block_loaded_ = false;
+        return false;
+    }
+
+    const size_t block = static_cast<size_t>(it - index_.begin());
+    if (!loadBlock(block))
+        return false;
+
+    position_ = static_cast<size_t>(
+        std::lower_bound(decoded_.begin(), decoded_.end(), time_ms,
+                         [](const track::TrackPoint& p, int64_t t) { return p.time_ms < t; }) -
+        decoded_.begin());
+    return true;
+}
+
+bool TrackReader::next(track::TrackPoint& point)
+{
+    while (!block_loaded_ || position_ >= decoded_.size()) {
+        const size_t block = block_loaded_ ? block_ + 1 : block_;
+        if (block >= index_.size())
+            return false;
+        if (!loadBlock(block)) {
+            // damage stays in its block; go on as if it were empty
+            ++bad_blocks_;
+            decoded_.clear();
+            block_loaded_ = true;
+        }
+    }
+
+    point = decoded_[position_++];
+    return true;
+}
+
+bool TrackReader::loadIndex()
+{
+    if (size_ < sizeof(track::FileHeader) + sizeof(track::Footer))
+        return false;
+
+    track::Footer footer;
+    std::memcpy(&footer, data_ + size_ - sizeof(footer), sizeof(footer));
+    const uint64_t index_bytes = static_cast<uint64_t>(footer.block_count) * sizeof(track::IndexEntry);
+    if (footer.magic != track::kFooterMagic || footer.index_offset + index_bytes + sizeof(footer) != size_)
+        return false;
+
+    index_.resize(footer.block_count);
+    std::memcpy(index_.data(), data_ + footer.index_offset, index_bytes);
+    point_count_ = footer.point_count;
+    return true;
+}
+
+void TrackReader::scanBlocks()
+{
+    recovered_ = true;
+    index_.clear();
+    point_count_ = 0U;
+
+    size_t offset = sizeof(track::FileHeader);
+    while (offset + sizeof(track::BlockHeader) <= size_) {
+        track::BlockHeader header;
+        std::memcpy(&header, data_ + offset, sizeof(header));
+        if (header.magic != track::kBlockMagic ||
+            offset + sizeof(header) + header.compressed_size > size_)
+            break;
+
+        index_.push_back(track::IndexEntry{header.first_time_ms, header.last_time_ms, offset,
+                                           header.point_count, 0U});
+        point_count_ += header.point_count;
+        offset += sizeof(header) + header.compressed_size;
+    }
+}
+
+bool TrackReader::loadBlock(size_t block)
+{
+    block_ = block;
+    position_ = 0U;
+    block_loaded_ = false;
+
+    const track::IndexEntry& entry = index_[block];
+    if (entry.offset + sizeof(track::BlockHeader) > size_)
+        return false;
+
+    track::BlockHeader header;
+    std::memcpy(&header, data_ + entry.offset, sizeof(header));
+    const uint8_t* compressed = data_ + entry.offset + sizeof(header);
+    if (header.magic != track::kBlockMagic ||
+        entry.offset + sizeof(header) + header.compressed_size > size_)
+        return false;
+
+    boost::crc_32_type crc;
+    crc.process_bytes(compressed, header.compressed_size);
+    if (crc.checksum() != header.crc)
+        return false;
+
+    scratch_.resize(header.raw_size);
+    uLongf raw_size = header.raw_size;
+    if (uncompress(scratch_.data(), &raw_size, compressed, header.compressed_size) != Z_OK ||
+        raw_size != header.raw_size)
+        return false;
+
+    decoded_.resize(header.point_count);
+    if (!track::codec::decodeColumns(scratch_.data(), raw_size, header.point_count, decoded_.data()))
+        return false;
+
+    block_loaded_ = true;
+    return true;
+}
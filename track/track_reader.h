@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "track_format.h"
+
+// Memory mapped reader for .mht files. Only the block under the cursor is
+// decoded, so seeking anywhere in a multi-day track costs one binary search
+// over the index plus one block decode.
+class TrackReader {
+    public:
+    explicit TrackReader(const std::filesystem::path& path);
+    ~TrackReader();
+
+    TrackReader(const TrackReader&) = delete;
+    TrackReader& operator=(const TrackReader&) = delete;
+
+    bool isOpen() const { return data_ != nullptr; }
+    uint64_t pointCount() const { return point_count_; }
+    size_t blockCount() const { return index_.size(); }
+    int64_t startTime() const;
+    int64_t endTime() const;
+
+    // true if the footer was missing and the index was rebuilt by scanning
+    bool wasRecovered() const { return recovered_; }
+    // blocks next() skipped for a bad crc or one that would not decode
+    size_t badBlocks() const { return bad_blocks_; }
+
+    // places the cursor on the first sample at or after time_ms
+    bool seek(int64_t time_ms);
+    bool next(track::TrackPoint& point);
+
+    private:
+    const uint8_t* data_{};
+    size_t size_{};
+    uint64_t point_count_{};
+    bool recovered_{};
+    size_t bad_blocks_{};
+    std::vector<track::IndexEntry> index_;
+
+    size_t block_{};
+    size_t position_{};
+    bool block_loaded_{};
+    std::vector<track::TrackPoint> decoded_;
+    std::vector<uint8_t> scratch_;
+
+    bool loadIndex();
+    void scanBlocks();
+    bool loadBlock(size_t block);
+};
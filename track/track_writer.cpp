@@ -0,0 +1,114 @@
+#include "track_writer.h"
+
+#include "track_codec.h"
+
+#include <limits>
+
+#include <boost/crc.hpp>
+#include <zlib.h>
+
+TrackWriter::TrackWriter(uint32_t block_points)
+    : block_points_(block_points == 0U ? track::kDefaultBlockPoints : block_points)
+{
+    pending_.reserve(block_points_);
+}
+
+TrackWriter::~TrackWriter()
+{
+    close();
+}
+
+bool TrackWriter::open(const std::filesystem::path& path)
+{
+    close();
+
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        return false;
+
+    offset_ = 0U;
+    point_count_ = 0U;
+    last_time_ms_ = std::numeric_limits<int64_t>::min();
+    index_.clear();
+    pending_.clear();
+
+    track::FileHeader header{};
+    header.magic = track::kFileMagic;
+    header.version = track::kFormatVersion;
+    header.column_count = track::kColumnCount;
+    header.block_points = block_points_;
+    return write(&header, sizeof(header));
+}
+
+bool TrackWriter::append(const track::TrackPoint& point)
+{
+    if (!out_.is_open())
+        return false;
+    if (point.time_ms <= last_time_ms_)
+        return true;
+
+    last_time_ms_ = point.time_ms;
+    pending_.push_back(point);
+    ++point_count_;
+
+    return pending_.size() < block_points_ || writeBlock();
+}
+
+bool TrackWriter::close()
+{
+    if (!out_.is_open())
+        return true;
+
+    bool ok = writeBlock();
+
+    track::Footer footer{};
+    footer.index_offset = offset_;
+    footer.point_count = point_count_;
+    footer.block_count = static_cast<uint32_t>(index_.size());
+    footer.magic = track::kFooterMagic;
+
+    ok = ok && write(index_.data(), index_.size() * sizeof(track::IndexEntry));
+    ok = ok && write(&footer, sizeof(footer));
+
+    out_.close();
+    return ok && !out_.fail();
+}
+
+bool TrackWriter::writeBlock()
+{
+    if (pending_.empty())
+        return true;
+
+    raw_.clear();
+    track::codec::encodeColumns(pending_.data(), pending_.size(), raw_);
+
+    uLongf compressed_size = compressBound(raw_.size());
+    compressed_.resize(compressed_size);
+    if (compress2(compressed_.data(), &compressed_size, raw_.data(), raw_.size(), Z_BEST_COMPRESSION) != Z_OK)
+        return false;
+
+    boost::crc_32_type crc;
+    crc.process_bytes(compressed_.data(), compressed_size);
+
+    track::BlockHeader header{};
+    header.magic = track::kBlockMagic;
+    header.point_count = static_cast<uint32_t>(pending_.size());
+    header.first_time_ms = pending_.front().time_ms;
+    header.last_time_ms = pending_.back().time_ms;
+    header.raw_size = static_cast<uint32_t>(raw_.size());
+    header.compressed_size = static_cast<uint32_t>(compressed_size);
+    header.crc = crc.checksum();
+
+    index_.push_back(track::IndexEntry{header.first_time_ms, header.last_time_ms, offset_,
+                                       header.point_count, 0U});
+    pending_.clear();
+
+    return write(&header, sizeof(header)) && write(compressed_.data(), compressed_size);
+}
+
+bool TrackWriter::write(const void* data, size_t length)
+{
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    offset_ += length;
+    return static_cast<bool>(out_);
+}
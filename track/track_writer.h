@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "track_format.h"
+
+// Appends samples to a .mht file one block at a time. Memory use is bounded
+// by a single block regardless of track length.
+class TrackWriter {
+    public:
+    explicit TrackWriter(uint32_t block_points = track::kDefaultBlockPoints);
+    ~TrackWriter();
+
+    TrackWriter(const TrackWriter&) = delete;
+    TrackWriter& operator=(const TrackWriter&) = delete;
+
+    bool open(const std::filesystem::path& path);
+
+    // samples must arrive in time order; a sample that is not newer than the
+    // previous one (a repeated epoch) is skipped
+    bool append(const track::TrackPoint& point);
+
+    // writes the pending block, the index and the footer
+    bool close();
+
+    uint64_t pointCount() const { return point_count_; }
+    uint64_t bytesWritten() const { return offset_; }
+
+    private:
+    uint32_t block_points_;
+    std::ofstream out_;
+    uint64_t offset_{};
+    uint64_t point_count_{};
+    int64_t last_time_ms_{};
+
+    std::vector<track::TrackPoint> pending_;
+    std::vector<track::IndexEntry> index_;
+    std::vector<uint8_t> raw_;
+    std::vector<uint8_t> compressed_;
+
+    bool writeBlock();
+    bool write(const void* data, size_t length);
+};
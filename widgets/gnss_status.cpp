@@ -15,7 +15,36 @@ void GnssStatus::buildUi()
     label_ = new QLabel("PAGE 2");
     label_->setAlignment(Qt::AlignCenter);
 
+    config_label_ = new QLabel("CFG idle");
+    config_label_->setAlignment(Qt::AlignCenter);
+
+    merge_label_ = new QLabel("SRC --");
+    merge_label_->setAlignment(Qt::AlignCenter);
+
+    rtcm_label_ = new QLabel;
+    rtcm_label_->setAlignment(Qt::AlignCenter);
+    rtcm_label_->setVisible(false);
+
+    governor_label_ = new QLabel("UI --");
+    governor_label_->setAlignment(Qt::AlignCenter);
+
+    perf_label_ = new QLabel("RUN --");
+    perf_label_->setAlignment(Qt::AlignCenter);
+
+    trip_label_ = new QLabel("TRIP --");
+    trip_label_->setAlignment(Qt::AlignCenter);
+
+    logger_label_ = new QLabel("LOG OFF");
+    logger_label_->setAlignment(Qt::AlignCenter);
+
     layout->addWidget(label_, 1);
+    layout->addWidget(config_label_);
+    layout->addWidget(merge_label_);
+    layout->addWidget(rtcm_label_);
+    layout->addWidget(governor_label_);
+    layout->addWidget(perf_label_);
+    layout->addWidget(trip_label_);
+    layout->addWidget(logger_label_);
 }
 
 void GnssStatus::setDisconnected()
@@ -32,4 +61,121 @@ void GnssStatus::updateFromGnss(const GnssPvt& s)
     label_->setText(QString("SV: %1  Mode: %2")
                         .arg(s.num_sv)
                         .arg(QString::fromStdString(s.differential_mode)));
+}
+
+void GnssStatus::setConfigStatus(const std::vector<GnssHub::ReceiverStatus>& receivers)
+{
+    if (!config_label_) return;
+
+    if (receivers.size() == 1)
+    {
+        config_label_->setText(receivers.front().link_status + "  " + receivers.front().config_status);
+        return;
+    }
+
+    QStringList lines;
+    for (size_t i = 0; i < receivers.size(); ++i)
+        lines << QString("RX%1 %2  %3").arg(i + 1).arg(receivers[i].link_status, receivers[i].config_status);
+    config_label_->setText(lines.join('\n'));
+}
+
+void GnssStatus::setMergeStatus(const EpochMerger::Merged& merged)
+{
+    if (!merge_label_) return;
+
+    if (!merged.valid)
+    {
+        merge_label_->setText("SRC --");
+        return;
+    }
+
+    QString text = QString("SRC RX%1  aligned %2/%3  changes %4")
+                       .arg(merged.source + 1)
+                       .arg(merged.aligned)
+                       .arg(merged.sources.size())
+                       .arg(merged.source_changes);
+    if (merged.dual_heading.valid)
+        text += QString("  HDG %1° ±%2 (%3 m)")
+                    .arg(merged.dual_heading.heading, 0, 'f', 1)
+                    .arg(merged.dual_heading.accuracy, 0, 'f', 1)
+                    .arg(merged.dual_heading.baseline_m, 0, 'f', 2);
+    if (merged.heading.valid)
+        text += QString("  shown %1° ±%2%3")
+                    .arg(merged.heading.heading, 0, 'f', 0)
+                    .arg(merged.heading.spread, 0, 'f', 1)
+                    .arg(merged.heading.holding ? " held" : "");
+    merge_label_->setText(text);
+}
+
+void GnssStatus::setCorrectionStatus(const QString& status)
+{
+    if (!rtcm_label_) return;
+    rtcm_label_->setText(status);
+    rtcm_label_->setVisible(!status.isEmpty());
+}
+
+void GnssStatus::setGovernorStatus(const QString& status)
+{
+    if (!governor_label_) return;
+    governor_label_->setText(status);
+}
+
+void GnssStatus::setPerformanceStatus(const PerformanceMeter::Status& perf)
+{
+    if (!perf_label_) return;
+
+    // a blank where the run never got there
+    const auto seconds = [](float s) { return s > 0.0f ? QString::number(s, 'f', 2) : QString("--"); };
+
+    QString text;
+    switch (perf.state)
+    {
+    case PerformanceMeter::State::kIdle: text = perf.braking ? "RUN braking" : "RUN --"; break;
+    case PerformanceMeter::State::kArmed: text = "RUN armed"; break;
+    case PerformanceMeter::State::kLaunch: text = QString("RUN %1 s").arg(perf.elapsed_s, 0, 'f', 1); break;
+    }
+
+    if (perf.have_last)
+    {
+        const perf::Run& r = perf.last;
+        if (r.kind == perf::RunKind::kLaunch)
+            text += QString("  last 0-30 %1  0-60 %2  1/4 %3 @ %4")
+                        .arg(seconds(r.zero_to_30_s), seconds(r.zero_to_60_s), seconds(r.quarter_mile_s))
+                        .arg(r.quarter_mile_mph, 0, 'f', 0);
+        else
+            text += QString("  last 60-0 %1 (%2 m)").arg(seconds(r.sixty_to_zero_s)).arg(r.sixty_to_zero_m, 0, 'f', 1);
+        text += QString(" ±%1 ms%2").arg(r.uncertainty_ms, 0, 'f', 0).arg(r.clean ? "" : " !");
+    }
+
+    text += QString("\nbest 0-60 %1  1/4 %2  60-0 %3  (%4 runs)")
+                .arg(seconds(perf.best_zero_to_60_s), seconds(perf.best_quarter_mile_s), seconds(perf.best_sixty_to_zero_s))
+                .arg(perf.runs);
+    perf_label_->setText(text);
+}
+
+void GnssStatus::setTripStatus(const persist::Trip& trip)
+{
+    if (!trip_label_) return;
+
+    static constexpr double kMetersPerMile = 1609.344;
+    const int minutes = static_cast<int>(trip.moving_s / 60.0);
+    trip_label_->setText(QString("TRIP %1 mi  moving %2:%3  max %4 mph")
+                             .arg(trip.distance_m / kMetersPerMile, 0, 'f', 1)
+                             .arg(minutes / 60)
+                             .arg(minutes % 60, 2, 10, QChar('0'))
+                             .arg(trip.max_mph, 0, 'f', 0));
+}
+
+void GnssStatus::setLoggerMetrics(const RideLogger::Metrics& m)
+{
+    if (!logger_label_) return;
+
+    logger_label_->setText(QString("LOG q: %1/%2 (max %3)  drop: %4  write: %5 us (max %6)  sync: %7 us")
+                               .arg(m.queue_depth)
+                               .arg(m.queue_capacity)
+                               .arg(m.queue_high_water)
+                               .arg(m.records_dropped)
+                               .arg(m.last_write_us)
+                               .arg(m.max_write_us)
+                               .arg(m.last_sync_us));
 }
\ No newline at end of file
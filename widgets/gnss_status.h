@@ -1,9 +1,13 @@
 #pragma once
 
+#include <vector>
+
 #include <QWidget>
 #include <QLabel>
 
-#include "devices/gnss_client.h"
+#include "core/persistent_state.h"
+#include "devices/gnss_hub.h"
+#include "logging/ride_logger.h"
 
 class GnssStatus : public QWidget
 {
@@ -14,10 +18,25 @@ public:
 
     void setDisconnected();
     void updateFromGnss(const GnssPvt& s);
+    void setLoggerMetrics(const RideLogger::Metrics& m);
+    void setConfigStatus(const std::vector<GnssHub::ReceiverStatus>& receivers);
+    void setMergeStatus(const EpochMerger::Merged& merged);
+    void setGovernorStatus(const QString& status);
+    void setPerformanceStatus(const PerformanceMeter::Status& perf);
+    void setTripStatus(const persist::Trip& trip);
+    // hidden when there is no correction source
+    void setCorrectionStatus(const QString& status);
 
 private:
     void buildUi();
 
 private:
     QLabel* label_ = nullptr;
+    QLabel* config_label_ = nullptr;
+    QLabel* merge_label_ = nullptr;
+    QLabel* rtcm_label_ = nullptr;
+    QLabel* governor_label_ = nullptr;
+    QLabel* perf_label_ = nullptr;
+    QLabel* trip_label_ = nullptr;
+    QLabel* logger_label_ = nullptr;
 };
\ No newline at end of file
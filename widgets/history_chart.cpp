@@ -0,0 +1,250 @@
+#include "widgets/history_chart.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include <QColor>
+#include <QFont>
+#include <QHBoxLayout>
+#include <QLineF>
+#include <QPainter>
+#include <QPen>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QVector>
+
+#include "devices/gnss_hub.h"
+
+namespace {
+
+struct Pane {
+    HistoryPyramid::Channel channel;
+    const char* title;
+    QColor color;
+    float step;      // axis limits snap to multiples of this
+    float min_range; // flat lines still get some height
+    bool from_zero;
+};
+
+const std::array<Pane, HistoryPyramid::kChannelCount> kPanes{{
+    {HistoryPyramid::kSpeed, "SPEED mph", QColor("#F0F0F0"), 10.0f, 10.0f, true},
+    {HistoryPyramid::kAltitude, "ALT ft", QColor("#8CB4FF"), 50.0f, 100.0f, false},
+    {HistoryPyramid::kSatellites, "SATS", QColor("#C8C8C8"), 5.0f, 5.0f, true},
+}};
+
+} // namespace
+
+// Draws the window the chart last fetched; owns no history of its own.
+class HistoryPlot : public QWidget
+{
+public:
+    explicit HistoryPlot(QWidget* parent)
+        : QWidget(parent)
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent);
+    }
+
+    HistoryPyramid::Window window;
+    int64_t from_ms = 0;
+    int64_t to_ms = 0;
+
+protected:
+    void paintEvent(QPaintEvent*) override;
+
+private:
+    QVector<QLineF> lines_; // reused, one entry per bucket
+
+    void paintPane(QPainter& painter, const QRectF& rect, const Pane& pane);
+};
+
+void HistoryPlot::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor("#101010"));
+
+    QFont font = painter.font();
+    font.setPointSize(11);
+    painter.setFont(font);
+
+    const qreal pane_height = height() / static_cast<qreal>(kPanes.size());
+    for (size_t i = 0; i < kPanes.size(); ++i)
+        paintPane(painter, QRectF(0, i * pane_height, width(), pane_height).adjusted(2, 2, -2, -2), kPanes[i]);
+}
+
+void HistoryPlot::paintPane(QPainter& painter, const QRectF& rect, const Pane& pane)
+{
+    painter.setPen(QColor("#404040"));
+    painter.drawRect(rect);
+
+    const size_t c = pane.channel;
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    const HistoryPyramid::Bucket* latest = nullptr;
+    for (const HistoryPyramid::Bucket& bucket : window.buckets)
+    {
+        if (bucket.count == 0U)
+            continue;
+        lo = std::min(lo, bucket.min[c]);
+        hi = std::max(hi, bucket.max[c]);
+        latest = &bucket;
+    }
+
+    painter.setPen(QColor("#B0B0B0"));
+    painter.drawText(rect.adjusted(6, 2, -6, -2), Qt::AlignLeft | Qt::AlignTop, pane.title);
+    if (!latest)
+        return;
+
+    if (pane.from_zero)
+        lo = 0.0f;
+    lo = std::floor(lo / pane.step) * pane.step;
+    hi = std::max(std::ceil(hi / pane.step) * pane.step, lo + pane.min_range);
+
+    painter.drawText(rect.adjusted(6, 2, -6, -2), Qt::AlignRight | Qt::AlignTop,
+                     QString("%1 .. %2").arg(lo, 0, 'f', 0).arg(hi, 0, 'f', 0));
+
+    const qreal x_scale = rect.width() / std::max<double>(static_cast<double>(to_ms - from_ms), 1.0);
+    const qreal y_scale = rect.height() / (hi - lo);
+    const auto y = [&](float value) { return rect.bottom() - (value - lo) * y_scale; };
+
+    // one vertical min-max stroke per bucket, stretched to meet its
+    // neighbour so the trace stays connected
+    lines_.clear();
+    const HistoryPyramid::Bucket* previous = nullptr;
+    for (const HistoryPyramid::Bucket& bucket : window.buckets)
+    {
+        if (bucket.count == 0U)
+        {
+            previous = nullptr; // leave gaps open
+            continue;
+        }
+        float top = bucket.max[c];
+        float bottom = bucket.min[c];
+        if (previous)
+        {
+            top = std::max(top, previous->min[c]);
+            bottom = std::min(bottom, previous->max[c]);
+        }
+        const qreal x = rect.left() +
+                        ((bucket.index * window.bucket_ms + window.bucket_ms / 2) - from_ms) * x_scale;
+        lines_.append(QLineF(x, y(bottom), x, y(top)));
+        previous = &bucket;
+    }
+
+    painter.setPen(QPen(pane.color, 0)); // cosmetic
+    painter.drawLines(lines_);
+
+    painter.setPen(pane.color);
+    painter.drawText(rect.adjusted(6, 2, -6, -2), Qt::AlignLeft | Qt::AlignBottom,
+                     QString::number(latest->max[c], 'f', 0));
+}
+
+HistoryChart::HistoryChart(const GnssHub* hub, QWidget* parent)
+    : QWidget(parent)
+    , hub_(hub)
+{
+    buildUi();
+}
+
+void HistoryChart::buildUi()
+{
+    auto* zoom_out = new QPushButton("−");
+    auto* zoom_in = new QPushButton("+");
+    auto* back = new QPushButton("◀◀");
+    auto* forward = new QPushButton("▶▶");
+    auto* live = new QPushButton("LIVE");
+
+    connect(zoom_out, &QPushButton::clicked, this, &HistoryChart::zoomOut);
+    connect(zoom_in, &QPushButton::clicked, this, &HistoryChart::zoomIn);
+    connect(back, &QPushButton::clicked, this, &HistoryChart::panBack);
+    connect(forward, &QPushButton::clicked, this, &HistoryChart::panForward);
+    connect(live, &QPushButton::clicked, this, &HistoryChart::goLive);
+
+    span_label_ = new QLabel;
+    span_label_->setAlignment(Qt::AlignCenter);
+
+    auto* controls = new QHBoxLayout;
+    controls->setContentsMargins(4, 2, 4, 2);
+    controls->addWidget(zoom_out);
+    controls->addWidget(zoom_in);
+    controls->addWidget(span_label_, 1);
+    controls->addWidget(back);
+    controls->addWidget(forward);
+    controls->addWidget(live);
+
+    plot_ = new HistoryPlot(this);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+    layout->addWidget(plot_, 1);
+    layout->addLayout(controls);
+}
+
+void HistoryChart::refresh()
+{
+    if (!hub_ || !plot_)
+        return;
+
+    const int64_t now_ms = steadyNowMs();
+    plot_->to_ms = end_ms_ == 0 ? now_ms : end_ms_;
+    plot_->from_ms = plot_->to_ms - spanMs();
+    // a bucket per pixel column is as fine as the screen can show
+    hub_->history(plot_->from_ms, plot_->to_ms, static_cast<size_t>(std::max(plot_->width(), 16)), plot_->window);
+
+    const int minutes = kSpansMinutes[span_];
+    QString text = minutes < 60 ? QString("%1 min").arg(minutes) : QString("%1 h").arg(minutes / 60);
+    if (end_ms_ != 0)
+        text += QString("  until -%1 min").arg((now_ms - end_ms_) / 60000.0, 0, 'f', 1);
+    span_label_->setText(text);
+
+    plot_->update();
+}
+
+void HistoryChart::zoomIn()
+{
+    if (span_ > 0U)
+        --span_;
+    refresh();
+}
+
+void HistoryChart::zoomOut()
+{
+    if (span_ + 1U < kSpansMinutes.size())
+        ++span_;
+    refresh();
+}
+
+void HistoryChart::panBack()
+{
+    // panning away from live pins the window to ride time
+    const int64_t now_ms = steadyNowMs();
+    const int64_t end_ms = end_ms_ == 0 ? now_ms : end_ms_;
+    end_ms_ = std::max(end_ms - spanMs() / 2, now_ms - kMaxLookbackMs);
+    refresh();
+}
+
+void HistoryChart::panForward()
+{
+    if (end_ms_ != 0)
+    {
+        end_ms_ += spanMs() / 2;
+        if (end_ms_ >= steadyNowMs())
+            end_ms_ = 0;
+    }
+    refresh();
+}
+
+void HistoryChart::goLive()
+{
+    end_ms_ = 0;
+    refresh();
+}
+
+int64_t HistoryChart::steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <QLabel>
+#include <QWidget>
+
+#include "core/history_pyramid.h"
+
+class GnssHub;
+class HistoryPlot;
+
+// Speed, altitude and satellites over the last minutes to hours. Every
+// refresh asks the hub's history pyramid for at most one bucket per pixel
+// column at the current zoom and pan, so drawing costs the same for a
+// minute of history as for a day of it.
+class HistoryChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // the hub must outlive the chart
+    explicit HistoryChart(const GnssHub* hub, QWidget* parent = nullptr);
+
+    // on the UI tick while the page is shown
+    void refresh();
+
+private slots:
+    void zoomIn();
+    void zoomOut();
+    void panBack();
+    void panForward();
+    void goLive();
+
+private:
+    static constexpr std::array<int, 10> kSpansMinutes{1, 2, 5, 10, 20, 30, 60, 120, 240, 480};
+    static constexpr int64_t kMaxLookbackMs = 24LL * 3600 * 1000;
+
+    const GnssHub* hub_ = nullptr;
+    HistoryPlot* plot_ = nullptr;
+    QLabel* span_label_ = nullptr;
+
+    size_t span_ = 3U;   // 10 minutes
+    int64_t end_ms_ = 0; // right edge in steady ms; 0 follows live
+
+    int64_t spanMs() const { return int64_t{kSpansMinutes[span_]} * 60 * 1000; }
+    void buildUi();
+    static int64_t steadyNowMs();
+};
@@ -8,18 +8,14 @@
 #include <QDateTime>
 #include <QDate>
 #include <QTime>
+#include <QEvent>
+#include <QStringList>
 
-static QFrame* makeTile(const QString& title,
-                        int primaryPt,
-                        int secondaryPt,
-                        QLabel** outPrimary,
-                        QLabel** outSecondary)
-{
-    auto* frame = new QFrame();
-    frame->setFrameShape(QFrame::StyledPanel);
-    frame->setFrameShadow(QFrame::Plain);
+#include "startup_trace.h"
 
-    frame->setStyleSheet(R"(
+// shared by every tile; set once on the page instead of parsing a copy per
+// tile. QLabel is a QFrame, so the frame rule styles the labels as before.
+static const char* kTileStyleSheet = R"(
 QFrame {
     border: 2px solid #404040;
     border-radius: 2px;
@@ -30,7 +26,17 @@ QLabel { padding: 0px; margin: 0px; }
 QLabel#title     { color: #B0B0B0; }
 QLabel#primary   { color: #F0F0F0; }
 QLabel#secondary { color: #C8C8C8; }
-)");
+)";
+
+static QFrame* makeTile(const QString& title,
+                        int primaryPt,
+                        int secondaryPt,
+                        QLabel** outPrimary,
+                        QLabel** outSecondary)
+{
+    auto* frame = new QFrame();
+    frame->setFrameShape(QFrame::StyledPanel);
+    frame->setFrameShadow(QFrame::Plain);
 
     auto* titleLabel = new QLabel(title);
     titleLabel->setObjectName("title");
@@ -82,11 +88,12 @@ SpeedometerCompass::SpeedometerCompass(QWidget* parent)
 
 void SpeedometerCompass::buildUi()
 {
-    QLabel* speed_secondary = nullptr;
+    setStyleSheet(kTileStyleSheet);
+
     QLabel* heading_secondary = nullptr;
 
     auto* speedTile = makeTile("miles per hour", 108, 16,
-                               &speed_value_, &speed_secondary);
+                               &speed_value_, &road_value_);
 
     auto* headingTile = makeTile("compass", 96, 36,
                                  &heading_value_, &heading_secondary);
@@ -115,12 +122,16 @@ void SpeedometerCompass::buildUi()
     fix_value_ = fix_secondary;
     date_value_ = time_secondary;
 
+    alert_tile_ = makeTile("ahead", 28, 14, &alert_value_, &alert_name_);
+    alert_tile_->setVisible(false);
+
     auto* bottom = new QGridLayout;
     bottom->setContentsMargins(0, 0, 0, 0);
     bottom->setSpacing(0);
     bottom->addWidget(timeTile, 0, 0);
     bottom->addWidget(odoTile,  0, 1);
     bottom->addWidget(fixTile,  0, 2);
+    bottom->addWidget(alert_tile_, 0, 3);
 
     auto* v = new QVBoxLayout(this);
     v->setContentsMargins(4, 2, 4, 2);
@@ -154,6 +165,79 @@ void SpeedometerCompass::setDisconnected()
         date_value_->setText("");
         date_value_->setVisible(false);
     }
+
+    setAlert(poi::Alert{});
+    setRoad(road::Match{});
+}
+
+void SpeedometerCompass::setLastKnown(float odo_miles, float heading)
+{
+    if (odo_value_)     odo_value_->setText(QString::number(odo_miles, 'f', 1));
+    if (heading_value_) heading_value_->setText(QString::fromStdString(degreesToCardinal(heading)));
+}
+
+void SpeedometerCompass::setAlert(const poi::Alert& alert)
+{
+    if (!alert_tile_)
+        return;
+
+    if (!alert.active)
+    {
+        alert_tile_->setVisible(false);
+        return;
+    }
+
+    // same units as the speed readout: feet up close, then miles
+    static constexpr float kFeetPerMeter = 3.28084f;
+    static constexpr float kMetersPerMile = 1609.344f;
+    const float miles = alert.distance_m / kMetersPerMile;
+    const QString distance = miles < 0.1f
+        ? QString("%1 ft").arg(static_cast<int>(alert.distance_m * kFeetPerMeter / 50.0f + 0.5f) * 50)
+        : QString("%1 mi").arg(miles, 0, 'f', 1);
+
+    alert_value_->setText(QString::fromStdString(alert.category).toUpper() + " " + distance);
+    alert_name_->setText(QString::fromStdString(alert.name));
+    alert_name_->setVisible(!alert.name.empty());
+    alert_tile_->setVisible(true);
+}
+
+void SpeedometerCompass::setRoad(const road::Match& road)
+{
+    if (!road_value_)
+        return;
+
+    if (!road.valid)
+    {
+        road_value_->setVisible(false);
+        return;
+    }
+
+    QStringList parts;
+    if (!road.name.empty())
+        parts << QString::fromStdString(road.name);
+    if (road.max_speed != 0U)
+        parts << QString("%1 %2").arg(road.max_speed).arg(road.limit_mph ? "mph" : "km/h");
+
+    // the match changes segment every few epochs, the text rarely does
+    const QString text = parts.join(QString(" ") + QChar(0x00B7) + " ");
+    if (road_value_->text() != text)
+        road_value_->setText(text);
+    road_value_->setVisible(!text.isEmpty());
+}
+
+void SpeedometerCompass::setDetail(FrameGovernor::Detail detail)
+{
+    detail_ = detail;
+}
+
+bool SpeedometerCompass::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == speed_value_ && event->type() == QEvent::Paint)
+    {
+        startup::mark("first speed rendered");
+        speed_value_->removeEventFilter(this);
+    }
+    return QWidget::eventFilter(watched, event);
 }
 
 void SpeedometerCompass::updateFromGnss(const GnssPvt& s, float odo_miles)
@@ -161,13 +245,33 @@ void SpeedometerCompass::updateFromGnss(const GnssPvt& s, float odo_miles)
     if (speed_value_)
         speed_value_->setText(QString::number(s.sog_mph, 'f', 0));
 
+    // report when the first decoded speed actually reaches the screen
+    if (speed_value_ && !first_speed_set_ && s.gps_tow_ms != 0U)
+    {
+        first_speed_set_ = true;
+        speed_value_->installEventFilter(this);
+    }
+
+    // the cardinal is filtered upstream and changes rarely; don't repaint
+    // for nothing
     if (heading_value_)
-        heading_value_->setText(s.cardinal_direction);
+    {
+        const QString cardinal = QString::fromStdString(s.cardinal_direction);
+        if (heading_value_->text() != cardinal)
+            heading_value_->setText(cardinal);
+    }
+
+    // secondary readouts change on nearly every tick; drop them when the
+    // frame governor asks for less detail
+    const bool full = detail_ == FrameGovernor::Detail::kFull;
 
     if (heading_degrees_value_)
     {
-        heading_degrees_value_->setText(QString::number(s.heading, 'f', 1) + QChar(0x00B0));
-        heading_degrees_value_->setVisible(true);
+        // whole degrees: the filtered heading is no better than that
+        const QString degrees = QString::number(s.heading, 'f', 0) + QChar(0x00B0);
+        if (full && heading_degrees_value_->text() != degrees)
+            heading_degrees_value_->setText(degrees);
+        heading_degrees_value_->setVisible(full);
     }
 
     const auto dt = s.utc_datetime;
@@ -177,12 +281,13 @@ void SpeedometerCompass::updateFromGnss(const GnssPvt& s, float odo_miles)
     const QDateTime local = datetime.toLocalTime();
 
     if (time_value_)
-        time_value_->setText(local.toString("hh:mm:ss"));
+        time_value_->setText(local.toString(detail_ == FrameGovernor::Detail::kMinimal ? "hh:mm" : "hh:mm:ss"));
 
     if (date_value_)
     {
-        date_value_->setText(local.toString("yyyy-MM-dd"));
-        date_value_->setVisible(true);
+        if (full)
+            date_value_->setText(local.toString("yyyy-MM-dd"));
+        date_value_->setVisible(full);
     }
 
     if (odo_value_)
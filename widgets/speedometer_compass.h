@@ -3,7 +3,12 @@
 #include <QWidget>
 #include <QLabel>
 
-#include "devices/gnss_client.h"
+#include "core/gnss_pvt.h"
+#include "frame_governor.h"
+#include "poi/poi_alerter.h"
+#include "road/road_matcher.h"
+
+class QFrame;
 
 class SpeedometerCompass : public QWidget
 {
@@ -13,13 +18,24 @@ public:
     explicit SpeedometerCompass(QWidget* parent = nullptr);
 
     void setDisconnected();
+    // odometer and heading from the state file, while there is no link
+    void setLastKnown(float odo_miles, float heading);
     void updateFromGnss(const GnssPvt& s, float odo_miles);
+    void setDetail(FrameGovernor::Detail detail);
+    // the tile is only on screen while an alert is active
+    void setAlert(const poi::Alert& alert);
+    // road name and posted limit under the speed; hidden off road
+    void setRoad(const road::Match& road);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     void buildUi();
 
 private:
     QLabel* speed_value_ = nullptr;
+    QLabel* road_value_ = nullptr;
 
     QLabel* heading_value_ = nullptr;
     QLabel* heading_degrees_value_ = nullptr;
@@ -31,4 +47,11 @@ private:
 
     QLabel* sv_value_ = nullptr;
     QLabel* fix_value_ = nullptr;
+
+    QFrame* alert_tile_ = nullptr;
+    QLabel* alert_value_ = nullptr;
+    QLabel* alert_name_ = nullptr;
+
+    bool first_speed_set_ = false;
+    FrameGovernor::Detail detail_ = FrameGovernor::Detail::kFull;
 };
\ No newline at end of file